@@ -0,0 +1,372 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <windows.h>
+#include "../Api/compress.h"
+#include "../Api/dump.h"
+#include "../Api/fields.h"
+#include "../Api/intern.h"
+
+/// <summary>
+///		Fleet summary of statistics files in one directory, the last dump of every file is used.
+///		Files are memory-mapped and parsed in place by worker threads, each worker sums into its own partial result
+/// </summary>
+class FleetAggregate
+{
+
+public:
+
+	/// <summary>
+	///		Values count of one field
+	/// </summary>
+	struct Group
+	{
+		size_t CategoryIndex {};
+		size_t FieldIndex {};
+
+		// Sorted by count in descending order
+		std::vector <std::pair <std::string, size_t>> Counts {};
+	};
+
+	/// <summary>
+	///		Values distribution of one numeric field
+	/// </summary>
+	struct Distribution
+	{
+		size_t CategoryIndex {};
+		size_t FieldIndex {};
+
+		// Sorted in ascending order
+		std::vector <double> Values {};
+
+		/// <summary>
+		///		Get nearest-rank percentile
+		/// </summary>
+		/// 
+		/// <param name="Rank">Percentile from 0 to 100</param>
+		/// 
+		/// <returns>double, 0 if there are no values</returns>
+		double Percentile(double Rank) const
+		{
+			if (Values.empty())
+			{
+				return 0;
+			}
+
+			size_t Index { (size_t)std::ceil(Rank / 100 * Values.size()) };
+
+			return Values.at(std::clamp <size_t>(Index, 1, Values.size()) - 1);
+		}
+	};
+
+	/// <summary>
+	///		Constructor
+	/// </summary>
+	FleetAggregate()
+	{
+		for (auto& Name : { std::make_pair(L"cpu", L"name"), std::make_pair(L"system", L"osversion"), std::make_pair(L"disk", L"mediatype"), std::make_pair(L"gpu", L"driverversion") })
+		{
+			Groups.push_back({});
+			FindField(Name.first, Name.second, Groups.back().CategoryIndex, Groups.back().FieldIndex);
+		}
+
+		for (auto& Name : { std::make_pair(L"physicalmemory", L"totalsize"), std::make_pair(L"disk", L"size") })
+		{
+			Distributions.push_back({});
+			FindField(Name.first, Name.second, Distributions.back().CategoryIndex, Distributions.back().FieldIndex);
+		}
+	}
+
+	/// <summary>
+	///		Aggregate every file in directory
+	/// </summary>
+	/// 
+	/// <param name="Directory">Directory</param>
+	/// 
+	/// <returns>bool, false if the directory can't be read</returns>
+	bool Run(const std::wstring& Directory)
+	{
+		std::vector <std::wstring> Files {};
+		WIN32_FIND_DATAW Data {};
+		HANDLE Find { FindFirstFileW((Directory + L"\\*").c_str(), &Data) };
+
+		if (Find == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		do
+		{
+			if (!(Data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+			{
+				Files.push_back(Directory + L"\\" + Data.cFileName);
+			}
+		} while (FindNextFileW(Find, &Data));
+
+		FindClose(Find);
+
+		// Files take different time to parse, so workers take the next file when they are done instead of fixed ranges
+		std::vector <Partial> Partials(std::clamp <size_t>(std::thread::hardware_concurrency(), 1, std::max <size_t>(Files.size(), 1)));
+		std::vector <std::thread> Workers {};
+		std::atomic <size_t> NextFile {};
+
+		for (auto& Result : Partials)
+		{
+			Result.Counts.resize(Groups.size());
+			Result.Values.resize(Distributions.size());
+
+			Workers.emplace_back([this, &Files, &NextFile, &Result]() {
+				InventoryDump Dump {};
+
+				for (size_t i; (i = NextFile.fetch_add(1, std::memory_order_relaxed)) < Files.size();)
+				{
+					Process(Files.at(i), Dump, Result);
+				}
+			});
+		}
+
+		for (auto& Worker : Workers)
+		{
+			Worker.join();
+		}
+
+		Merge(Partials);
+
+		return true;
+	}
+
+	/// <summary>
+	///		Get number of aggregated snapshots
+	/// </summary>
+	/// 
+	/// <returns>size_t</returns>
+	size_t GetSnapshots() const
+	{
+		return Snapshots;
+	}
+
+	/// <summary>
+	///		Get number of files without dump
+	/// </summary>
+	/// 
+	/// <returns>size_t</returns>
+	size_t GetSkipped() const
+	{
+		return Skipped;
+	}
+
+	/// <summary>
+	///		Get values counts
+	/// </summary>
+	/// 
+	/// <returns>const std::vector <Group>&</returns>
+	const std::vector <Group>& GetGroups() const
+	{
+		return Groups;
+	}
+
+	/// <summary>
+	///		Get values distributions
+	/// </summary>
+	/// 
+	/// <returns>const std::vector <Distribution>&</returns>
+	const std::vector <Distribution>& GetDistributions() const
+	{
+		return Distributions;
+	}
+
+private:
+
+	/// <summary>
+	///		Worker result
+	/// </summary>
+	struct Partial
+	{
+		// Values of all groups are interned once, counts are indexed by value id
+		StringPool <char> Pool {};
+		std::vector <std::vector <size_t>> Counts {};
+		std::vector <std::vector <double>> Values {};
+		size_t Snapshots {};
+		size_t Skipped {};
+
+		// Decompressed file text
+		std::string Text {};
+	};
+
+	/// <summary>
+	///		Find category and field indices by names
+	/// </summary>
+	/// 
+	/// <param name="CategoryName">Category name</param>
+	/// <param name="FieldName">Field name</param>
+	/// <param name="CategoryIndex">Category index</param>
+	/// <param name="FieldIndex">Field index</param>
+	static void FindField(const wchar_t* CategoryName, const wchar_t* FieldName, size_t& CategoryIndex, size_t& FieldIndex)
+	{
+		for (CategoryIndex = 0; Fields::Categories.at(CategoryIndex).Name != CategoryName; CategoryIndex++);
+
+		auto& Category { Fields::Categories.at(CategoryIndex) };
+
+		for (FieldIndex = 0; Category.Fields.at(FieldIndex).Name != FieldName; FieldIndex++);
+	}
+
+	/// <summary>
+	///		Map file, parse its last dump and add it to partial result
+	/// </summary>
+	/// 
+	/// <param name="Path">File</param>
+	/// <param name="Dump">Dump reused between files</param>
+	/// <param name="Result">Partial result</param>
+	void Process(const std::wstring& Path, InventoryDump& Dump, Partial& Result)
+	{
+		HANDLE File { CreateFileW(Path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr) };
+		HANDLE Mapping {};
+		const char* View {};
+		LARGE_INTEGER Size {};
+		bool bParsed {};
+
+		// Empty files can't be mapped
+		if (File != INVALID_HANDLE_VALUE && GetFileSizeEx(File, &Size) && Size.QuadPart > 0
+			&& (Mapping = CreateFileMappingW(File, nullptr, PAGE_READONLY, 0, 0, nullptr))
+			&& (View = (const char*)MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0)))
+		{
+			std::string_view Content(View, (size_t)Size.QuadPart);
+
+			// Compressed files are decompressed into the worker buffer, plain files are parsed in place
+			if (BlockCompression::IsCompressed(Content))
+			{
+				Result.Text.clear();
+				bParsed = BlockCompression::DecompressBlocks(Content, Result.Text) && Dump.Parse(Result.Text, 0);
+			}
+			else
+			{
+				bParsed = Dump.Parse(Content, 0);
+			}
+		}
+
+		if (bParsed)
+		{
+			Result.Snapshots++;
+
+			for (size_t i = 0; i < Groups.size(); i++)
+			{
+				for (auto& Record : Dump.GetRecords(Groups.at(i).CategoryIndex))
+				{
+					std::string_view Value { Record.at(Groups.at(i).FieldIndex) };
+
+					if (Value.data())
+					{
+						auto& Counts { Result.Counts.at(i) };
+						unsigned int Id { Result.Pool.Intern(Value) };
+
+						if (Id >= Counts.size())
+						{
+							Counts.resize(Id + 1);
+						}
+
+						Counts.at(Id)++;
+					}
+				}
+			}
+
+			for (size_t i = 0; i < Distributions.size(); i++)
+			{
+				for (auto& Record : Dump.GetRecords(Distributions.at(i).CategoryIndex))
+				{
+					std::string_view Value { Record.at(Distributions.at(i).FieldIndex) };
+					double Number {};
+
+					// Unit after the number is ignored
+					if (Value.data() && std::from_chars(Value.data(), Value.data() + Value.size(), Number).ec == std::errc {})
+					{
+						Result.Values.at(i).push_back(Number);
+					}
+				}
+			}
+		}
+		else
+		{
+			Result.Skipped++;
+		}
+
+		if (View)
+		{
+			UnmapViewOfFile(View);
+		}
+
+		if (Mapping)
+		{
+			CloseHandle(Mapping);
+		}
+
+		if (File != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(File);
+		}
+	}
+
+	/// <summary>
+	///		Merge partial results, sort counts and values
+	/// </summary>
+	/// 
+	/// <param name="Partials">Partial results</param>
+	void Merge(std::vector <Partial>& Partials)
+	{
+		Snapshots = Skipped = 0;
+
+		for (size_t i = 0; i < Groups.size(); i++)
+		{
+			std::unordered_map <std::string_view, size_t> Counts {};
+
+			for (auto& Result : Partials)
+			{
+				for (unsigned int Id = 0; Id < Result.Counts.at(i).size(); Id++)
+				{
+					if (Result.Counts.at(i).at(Id))
+					{
+						Counts[Result.Pool.Get(Id)] += Result.Counts.at(i).at(Id);
+					}
+				}
+			}
+
+			Groups.at(i).Counts.assign(Counts.begin(), Counts.end());
+
+			std::sort(Groups.at(i).Counts.begin(), Groups.at(i).Counts.end(), [](auto& Left, auto& Right) {
+				return Left.second != Right.second ? Left.second > Right.second : Left.first < Right.first;
+			});
+		}
+
+		for (size_t i = 0; i < Distributions.size(); i++)
+		{
+			auto& Values { Distributions.at(i).Values };
+
+			Values.clear();
+
+			for (auto& Result : Partials)
+			{
+				Values.insert(Values.end(), Result.Values.at(i).begin(), Result.Values.at(i).end());
+			}
+
+			std::sort(Values.begin(), Values.end());
+		}
+
+		for (auto& Result : Partials)
+		{
+			Snapshots += Result.Snapshots;
+			Skipped += Result.Skipped;
+		}
+	}
+
+	std::vector <Group> Groups {};
+	std::vector <Distribution> Distributions {};
+	size_t Snapshots {};
+	size_t Skipped {};
+};
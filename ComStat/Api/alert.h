@@ -0,0 +1,389 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cwctype>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/// <summary>
+///		Threshold alert engine
+/// </summary>
+class AlertEngine
+{
+
+public:
+
+	/// <summary>
+	///		Alert metrics enum
+	/// </summary>
+	enum
+	{
+		eCPULoad,
+		eMemoryLoad,
+		eFreeSpace
+	};
+
+	/// <summary>
+	///		Comparison operators enum
+	/// </summary>
+	enum
+	{
+		eGreater,
+		eGreaterEqual,
+		eLess,
+		eLessEqual
+	};
+
+	/// <summary>
+	///		Alert event
+	/// </summary>
+	struct Event
+	{
+		bool IsStart {};
+		float Value {};
+		const std::wstring* Rule {};
+	};
+
+	/// <summary>
+	///		Compile rules file
+	/// </summary>
+	/// 
+	/// <param name="FileName">Rules file name</param>
+	/// <param name="Errors">Rules that can't be compiled</param>
+	/// 
+	/// <returns>bool</returns>
+	bool Compile(const wchar_t* FileName, std::vector <std::wstring>& Errors)
+	{
+		std::wifstream RulesFile(FileName);
+		std::wstring Line {};
+
+		Rules.clear();
+		Drives.clear();
+		bCompiled = true;
+
+		if (!RulesFile.is_open())
+		{
+			return false;
+		}
+
+		for (int LineNumber = 1; std::getline(RulesFile, Line); LineNumber++)
+		{
+			// Skip comments and empty lines
+			if (Line.empty() || Line.at(0) == L'#' || Line.find_first_not_of(L" \t\r") == std::wstring::npos)
+			{
+				continue;
+			}
+
+			if (!CompileRule(Line))
+			{
+				Errors.push_back(L"line " + std::to_wstring(LineNumber) + L": " + Line);
+			}
+		}
+
+		Values.assign(2 + Drives.size(), 0.0f);
+
+		return true;
+	}
+
+	/// <summary>
+	///		Check if rules were compiled
+	/// </summary>
+	/// 
+	/// <returns>bool</returns>
+	bool IsCompiled() const
+	{
+		return bCompiled;
+	}
+
+	/// <summary>
+	///		Check if there are no rules
+	/// </summary>
+	/// 
+	/// <returns>bool</returns>
+	bool IsEmpty() const
+	{
+		return Rules.empty();
+	}
+
+	/// <summary>
+	///		Drives referenced by rules, their free space must be passed to SetFreeSpace
+	/// </summary>
+	/// 
+	/// <returns>const std::vector <std::wstring>&</returns>
+	const std::vector <std::wstring>& GetDrives() const
+	{
+		return Drives;
+	}
+
+	/// <summary>
+	///		Set current CPU and memory load, negative value means there is no sample
+	/// </summary>
+	/// 
+	/// <param name="CPULoad">CPU load in %</param>
+	/// <param name="MemoryLoad">Memory load in %</param>
+	void SetLoad(float CPULoad, float MemoryLoad)
+	{
+		Values.at(eCPULoad) = CPULoad;
+		Values.at(eMemoryLoad) = MemoryLoad;
+	}
+
+	/// <summary>
+	///		Set current free space of the drive returned by GetDrives, negative if the drive is missing
+	/// </summary>
+	/// 
+	/// <param name="DriveIndex">Drive index</param>
+	/// <param name="FreeSpace">Free space in GB</param>
+	void SetFreeSpace(int DriveIndex, float FreeSpace)
+	{
+		Values.at(eFreeSpace + DriveIndex) = FreeSpace;
+	}
+
+	/// <summary>
+	///		Evaluate all rules against the current sample, rules of metrics without a sample keep their state
+	/// </summary>
+	/// 
+	/// <param name="Now">Sample time</param>
+	/// <param name="Events">Started and ended alerts</param>
+	void Evaluate(std::chrono::steady_clock::time_point Now, std::vector <Event>& Events)
+	{
+		Events.clear();
+
+		for (auto& Rule : Rules)
+		{
+			float Value { Values[Rule.Slot] };
+
+			// E.g. removed drive, it's neither a breach nor a recovery, but the condition didn't hold the whole duration
+			if (Value < 0)
+			{
+				Rule.bPending = false;
+				continue;
+			}
+
+			if (!Rule.bActive)
+			{
+				if (!Breached(Rule.Operator, Value, Rule.Threshold))
+				{
+					Rule.bPending = false;
+					continue;
+				}
+
+				// Condition must hold for the whole duration
+				if (!Rule.bPending)
+				{
+					Rule.bPending = true;
+					Rule.PendingSince = Now;
+				}
+
+				if (Now - Rule.PendingSince >= Rule.Duration)
+				{
+					Rule.bActive = true;
+					Rule.bPending = false;
+					Events.push_back({ true, Value, &Rule.Text });
+				}
+			}
+			// Alert ends only after the value is back beyond the hysteresis band
+			else if (Recovered(Rule.Operator, Value, Rule.Threshold, Rule.Hysteresis))
+			{
+				Rule.bActive = false;
+				Events.push_back({ false, Value, &Rule.Text });
+			}
+		}
+	}
+
+private:
+
+	/// <summary>
+	///		Compiled rule
+	/// </summary>
+	struct CompiledRule
+	{
+		std::wstring Text {};
+		int Slot {};
+		int Operator {};
+		float Threshold {};
+		float Hysteresis {};
+		std::chrono::steady_clock::duration Duration {};
+		std::chrono::steady_clock::time_point PendingSince {};
+		bool bPending {};
+		bool bActive {};
+	};
+
+	/// <summary>
+	///		Compile one rule, e.g. "cpu > 90 for 30 hysteresis 5" or "freespace C: < 5"
+	/// </summary>
+	/// 
+	/// <param name="Line">Rule text</param>
+	/// 
+	/// <returns>bool</returns>
+	bool CompileRule(const std::wstring& Line)
+	{
+		std::wistringstream Stream(Line);
+		std::wstring Metric {};
+		std::wstring Operator {};
+		std::wstring Keyword {};
+		CompiledRule Rule {};
+
+		if (!(Stream >> Metric))
+		{
+			return false;
+		}
+
+		// Metric, e.g. "CPU" or "FreeSpace c:"
+		Lowercase(Metric);
+
+		if (Metric == L"cpu")
+		{
+			Rule.Slot = eCPULoad;
+		}
+		else if (Metric == L"memory")
+		{
+			Rule.Slot = eMemoryLoad;
+		}
+		else if (Metric == L"freespace")
+		{
+			std::wstring Drive {};
+
+			if (!(Stream >> Drive))
+			{
+				return false;
+			}
+
+			for (auto& Symbol : Drive)
+			{
+				Symbol = (wchar_t)std::towupper(Symbol);
+			}
+
+			auto Found { std::find(Drives.begin(), Drives.end(), Drive) };
+			Rule.Slot = eFreeSpace + (int)(Found - Drives.begin());
+
+			if (Found == Drives.end())
+			{
+				Drives.push_back(Drive);
+			}
+		}
+		else
+		{
+			return false;
+		}
+
+		// Comparison
+		if (!(Stream >> Operator >> Rule.Threshold))
+		{
+			return false;
+		}
+
+		if (Operator == L">")
+		{
+			Rule.Operator = eGreater;
+		}
+		else if (Operator == L">=")
+		{
+			Rule.Operator = eGreaterEqual;
+		}
+		else if (Operator == L"<")
+		{
+			Rule.Operator = eLess;
+		}
+		else if (Operator == L"<=")
+		{
+			Rule.Operator = eLessEqual;
+		}
+		else
+		{
+			return false;
+		}
+
+		// Optional duration (seconds) and hysteresis
+		while (Stream >> Keyword)
+		{
+			float Argument {};
+
+			if (!(Stream >> Argument) || Argument < 0)
+			{
+				return false;
+			}
+
+			Lowercase(Keyword);
+
+			if (Keyword == L"for")
+			{
+				Rule.Duration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(Argument));
+			}
+			else if (Keyword == L"hysteresis")
+			{
+				Rule.Hysteresis = Argument;
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		Rule.Text = Line;
+		Rules.push_back(Rule);
+
+		return true;
+	}
+
+	/// <summary>
+	///		Convert rule word to lowercase, keywords aren't case sensitive
+	/// </summary>
+	/// 
+	/// <param name="Word">Word</param>
+	static void Lowercase(std::wstring& Word)
+	{
+		for (auto& Symbol : Word)
+		{
+			Symbol = (wchar_t)std::towlower(Symbol);
+		}
+	}
+
+	/// <summary>
+	///		Check if value breaches threshold
+	/// </summary>
+	/// 
+	/// <param name="Operator">Comparison operator</param>
+	/// <param name="Value">Current value</param>
+	/// <param name="Threshold">Threshold</param>
+	/// 
+	/// <returns>bool</returns>
+	static bool Breached(int Operator, float Value, float Threshold)
+	{
+		switch (Operator)
+		{
+		case eGreater:
+			return Value > Threshold;
+		case eGreaterEqual:
+			return Value >= Threshold;
+		case eLess:
+			return Value < Threshold;
+		case eLessEqual:
+			return Value <= Threshold;
+		}
+
+		return false;
+	}
+
+	/// <summary>
+	///		Check if value returned beyond threshold and hysteresis
+	/// </summary>
+	/// 
+	/// <param name="Operator">Comparison operator</param>
+	/// <param name="Value">Current value</param>
+	/// <param name="Threshold">Threshold</param>
+	/// <param name="Hysteresis">Hysteresis</param>
+	/// 
+	/// <returns>bool</returns>
+	static bool Recovered(int Operator, float Value, float Threshold, float Hysteresis)
+	{
+		return !Breached(Operator, Value, (Operator == eGreater || Operator == eGreaterEqual) ? Threshold - Hysteresis : Threshold + Hysteresis);
+	}
+
+	std::vector <CompiledRule> Rules {};
+	std::vector <std::wstring> Drives {};
+	std::vector <float> Values { 0.0f, 0.0f };
+	bool bCompiled {};
+};
@@ -0,0 +1,786 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#define OFFLOAD_WORKERS 4
+#define OFFLOAD_ABANDONED_WORKERS 4
+
+/// <summary>
+///		Coroutine collection layer: lazily started tasks, awaiting all of them at once and a small executor.
+///		Coroutines run on one loop thread, blocking calls are offloaded to a small worker pool, so many queries are in flight at once
+/// </summary>
+namespace Async
+{
+	template <typename T>
+	class Task;
+
+	/// <summary>
+	///		Promise part shared by tasks of all result types
+	/// </summary>
+	struct PromiseBase
+	{
+		/// <summary>
+		///		Resumes awaiting coroutine when the task finishes
+		/// </summary>
+		struct FinalAwaiter
+		{
+			bool await_ready() noexcept
+			{
+				return false;
+			}
+
+			template <typename Promise>
+			std::coroutine_handle <> await_suspend(std::coroutine_handle <Promise> Handle) noexcept
+			{
+				auto Continuation { Handle.promise().Continuation };
+
+				return Continuation ? Continuation : std::noop_coroutine();
+			}
+
+			void await_resume() noexcept {}
+		};
+
+		std::suspend_always initial_suspend() noexcept
+		{
+			return {};
+		}
+
+		FinalAwaiter final_suspend() noexcept
+		{
+			return {};
+		}
+
+		void unhandled_exception()
+		{
+			Error = std::current_exception();
+		}
+
+		std::coroutine_handle <> Continuation {};
+		std::exception_ptr Error {};
+	};
+
+	/// <summary>
+	///		Promise of task with result
+	/// </summary>
+	/// 
+	/// <typeparam name="T">Result type</typeparam>
+	template <typename T>
+	struct Promise : PromiseBase
+	{
+		Task <T> get_return_object();
+
+		void return_value(T Result)
+		{
+			Value = std::move(Result);
+		}
+
+		T Value {};
+	};
+
+	/// <summary>
+	///		Promise of task without result
+	/// </summary>
+	template <>
+	struct Promise <void> : PromiseBase
+	{
+		Task <void> get_return_object();
+
+		void return_void() {}
+	};
+
+	/// <summary>
+	///		Lazily started coroutine, it starts when it's awaited and resumes the awaiting coroutine when it finishes
+	/// </summary>
+	/// 
+	/// <typeparam name="T">Result type</typeparam>
+	template <typename T = void>
+	class Task
+	{
+
+	public:
+
+		using promise_type = Promise <T>;
+
+		/// <summary>
+		///		Constructor
+		/// </summary>
+		/// 
+		/// <param name="Handle">Coroutine</param>
+		explicit Task(std::coroutine_handle <promise_type> Handle) : Handle(Handle) {}
+
+		Task(Task&& Other) noexcept : Handle(std::exchange(Other.Handle, {})) {}
+
+		Task& operator=(Task&& Other) noexcept
+		{
+			if (this != &Other)
+			{
+				if (Handle)
+				{
+					Handle.destroy();
+				}
+
+				Handle = std::exchange(Other.Handle, {});
+			}
+
+			return *this;
+		}
+
+		Task(const Task&) = delete;
+		Task& operator=(const Task&) = delete;
+
+		/// <summary>
+		///		Destructor
+		/// </summary>
+		~Task()
+		{
+			if (Handle)
+			{
+				Handle.destroy();
+			}
+		}
+
+		bool await_ready() const noexcept
+		{
+			return !Handle || Handle.done();
+		}
+
+		std::coroutine_handle <> await_suspend(std::coroutine_handle <> Awaiting) noexcept
+		{
+			Handle.promise().Continuation = Awaiting;
+
+			return Handle;
+		}
+
+		T await_resume()
+		{
+			if (Handle.promise().Error)
+			{
+				std::rethrow_exception(Handle.promise().Error);
+			}
+
+			if constexpr (!std::is_void_v <T>)
+			{
+				return std::move(Handle.promise().Value);
+			}
+		}
+
+	private:
+
+		std::coroutine_handle <promise_type> Handle {};
+	};
+
+	template <typename T>
+	Task <T> Promise <T>::get_return_object()
+	{
+		return Task <T>(std::coroutine_handle <Promise <T>>::from_promise(*this));
+	}
+
+	inline Task <void> Promise <void>::get_return_object()
+	{
+		return Task <void>(std::coroutine_handle <Promise <void>>::from_promise(*this));
+	}
+
+	/// <summary>
+	///		Coroutine which starts at once and destroys itself when it finishes
+	/// </summary>
+	struct Detached
+	{
+		struct promise_type
+		{
+			Detached get_return_object() noexcept
+			{
+				return {};
+			}
+
+			std::suspend_never initial_suspend() noexcept
+			{
+				return {};
+			}
+
+			std::suspend_never final_suspend() noexcept
+			{
+				return {};
+			}
+
+			void return_void() noexcept {}
+
+			void unhandled_exception() noexcept
+			{
+				std::terminate();
+			}
+		};
+	};
+
+	/// <summary>
+	///		Awaiter of several tasks running at once, the awaiting coroutine resumes when the last one finishes
+	/// </summary>
+	class AllAwaiter
+	{
+
+	public:
+
+		/// <summary>
+		///		Constructor
+		/// </summary>
+		/// 
+		/// <param name="Tasks">Tasks, results are true if the task completed fully</param>
+		explicit AllAwaiter(std::vector <Task <bool>>& Tasks) : Tasks(Tasks) {}
+
+		bool await_ready() const noexcept
+		{
+			return Tasks.empty();
+		}
+
+		bool await_suspend(std::coroutine_handle <> Awaiting)
+		{
+			Continuation = Awaiting;
+
+			// One extra count, so tasks finishing right away don't resume the awaiting coroutine before it's suspended
+			Remaining.store(Tasks.size() + 1, std::memory_order_relaxed);
+
+			for (auto& Started : Tasks)
+			{
+				Run(Started);
+			}
+
+			return Remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+		}
+
+		bool await_resume()
+		{
+			if (Error)
+			{
+				std::rethrow_exception(Error);
+			}
+
+			return bComplete;
+		}
+
+	private:
+
+		/// <summary>
+		///		Run one task and count it when it finishes
+		/// </summary>
+		/// 
+		/// <param name="Started">Task</param>
+		/// 
+		/// <returns>Detached</returns>
+		Detached Run(Task <bool>& Started)
+		{
+			try
+			{
+				bComplete = co_await Started && bComplete;
+			}
+			catch (...)
+			{
+				Error = std::current_exception();
+			}
+
+			if (Remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				Continuation.resume();
+			}
+		}
+
+		std::vector <Task <bool>>& Tasks;
+		std::atomic <size_t> Remaining {};
+		std::coroutine_handle <> Continuation {};
+		std::exception_ptr Error {};
+		bool bComplete { true };
+	};
+
+	/// <summary>
+	///		Await tasks running at once
+	/// </summary>
+	/// 
+	/// <param name="Tasks">Tasks</param>
+	/// 
+	/// <returns>Task <bool>, true if all tasks completed fully</returns>
+	inline Task <bool> WhenAll(std::vector <Task <bool>> Tasks)
+	{
+		co_return co_await AllAwaiter(Tasks);
+	}
+
+	/// <summary>
+	///		Offloaded call state shared by its worker and its deadline timer, whichever claims it first resumes the awaiting coroutine.
+	///		Started and abandoned flags are guarded by the pool mutex
+	/// </summary>
+	struct OffloadState
+	{
+		std::atomic <bool> bClaimed {};
+		std::atomic <bool> bFinished {};
+		bool bStarted {};
+		bool bAbandoned {};
+	};
+
+	/// <summary>
+	///		Executor: loop thread resumes ready and sleeping coroutines, offloaded calls run on a bounded worker pool.
+	///		Worker stuck in a call past its deadline is replaced, up to OFFLOAD_ABANDONED_WORKERS at once
+	/// </summary>
+	class Executor
+	{
+
+	public:
+
+		using Clock = std::chrono::steady_clock;
+
+		/// <summary>
+		///		Destructor
+		/// </summary>
+		~Executor()
+		{
+			{
+				std::lock_guard <std::mutex> Lock(Mutex);
+				bStop = true;
+			}
+
+			Ready.notify_all();
+
+			if (Loop.joinable())
+			{
+				Loop.join();
+			}
+
+			// Workers aren't joined, an abandoned one may be stuck in the OS, idle ones leave
+			{
+				std::lock_guard <std::mutex> Lock(Pool->Mutex);
+				Pool->bStop = true;
+			}
+
+			Pool->Queued.notify_all();
+		}
+
+		/// <summary>
+		///		Run task on the loop thread and wait for its result, it isn't called from the loop thread
+		/// </summary>
+		/// 
+		/// <typeparam name="T">Result type</typeparam>
+		/// <param name="Started">Task</param>
+		/// 
+		/// <returns>T</returns>
+		template <typename T>
+		T Run(Task <T> Started)
+		{
+			std::mutex Done {};
+			std::condition_variable Finished {};
+			std::exception_ptr Error {};
+			bool bFinished {};
+
+			auto Wait { [&]() {
+				std::unique_lock <std::mutex> Lock(Done);
+				Finished.wait(Lock, [&]() { return bFinished; });
+
+				if (Error)
+				{
+					std::rethrow_exception(Error);
+				}
+			} };
+
+			if constexpr (std::is_void_v <T>)
+			{
+				Drive(Started, Done, Finished, Error, bFinished);
+				Wait();
+			}
+			else
+			{
+				T Result {};
+
+				Drive(Started, Done, Finished, Error, bFinished, &Result);
+				Wait();
+
+				return Result;
+			}
+		}
+
+		/// <summary>
+		///		Move awaiting coroutine to the loop thread
+		/// </summary>
+		/// 
+		/// <returns>Awaiter</returns>
+		auto Schedule()
+		{
+			struct Awaiter
+			{
+				Executor& Owner;
+
+				bool await_ready() const noexcept
+				{
+					return false;
+				}
+
+				void await_suspend(std::coroutine_handle <> Handle)
+				{
+					Owner.Post(Handle, Clock::now());
+				}
+
+				void await_resume() const noexcept {}
+			};
+
+			return Awaiter { *this };
+		}
+
+		/// <summary>
+		///		Suspend awaiting coroutine, other coroutines run meanwhile
+		/// </summary>
+		/// 
+		/// <param name="Duration">Duration</param>
+		/// 
+		/// <returns>Awaiter</returns>
+		auto Sleep(std::chrono::milliseconds Duration)
+		{
+			struct Awaiter
+			{
+				Executor& Owner;
+				Clock::time_point Time;
+
+				bool await_ready() const noexcept
+				{
+					return false;
+				}
+
+				void await_suspend(std::coroutine_handle <> Handle)
+				{
+					Owner.Post(Handle, Time);
+				}
+
+				void await_resume() const noexcept {}
+			};
+
+			return Awaiter { *this, Clock::now() + Duration };
+		}
+
+		/// <summary>
+		///		Run blocking call on the worker pool, the awaiting coroutine resumes on the loop thread after it or at the deadline.
+		///		Running call which misses the deadline is abandoned and keeps running, so it must own everything it uses, e.g. by shared_ptr.
+		///		Queued call which misses the deadline isn't run at all
+		/// </summary>
+		/// 
+		/// <param name="Call">Blocking call, e.g. connection or device I/O</param>
+		/// <param name="Deadline">Deadline, the call is awaited as long as it runs by default</param>
+		/// 
+		/// <returns>Awaiter, it results in false if the call was abandoned</returns>
+		auto Offload(std::function <void()> Call, Clock::time_point Deadline = Clock::time_point::max())
+		{
+			struct Awaiter
+			{
+				Executor& Owner;
+				std::function <void()> Call;
+				Clock::time_point Deadline;
+				std::shared_ptr <OffloadState> State {};
+
+				bool await_ready() const noexcept
+				{
+					return false;
+				}
+
+				void await_suspend(std::coroutine_handle <> Handle)
+				{
+					// Coroutine may be resumed and the awaiter destroyed before the call is queued, so members are copied first
+					auto Shared { State = std::make_shared <OffloadState>() };
+					auto Time { Deadline };
+					Executor* Loop { &Owner };
+
+					Loop->Submit(Job { std::move(Call), Handle, Shared });
+
+					if (Time != Clock::time_point::max())
+					{
+						Loop->Post(Handle, Time, Shared);
+					}
+				}
+
+				bool await_resume() const noexcept
+				{
+					return State->bFinished.load(std::memory_order_acquire);
+				}
+			};
+
+			return Awaiter { *this, std::move(Call), Deadline };
+		}
+
+	private:
+
+		/// <summary>
+		///		Coroutine resumed at time
+		/// </summary>
+		struct Timer
+		{
+			Clock::time_point Time {};
+			std::coroutine_handle <> Handle {};
+			std::shared_ptr <OffloadState> Claim {};
+		};
+
+		/// <summary>
+		///		Offloaded call waiting for a worker
+		/// </summary>
+		struct Job
+		{
+			std::function <void()> Call {};
+			std::coroutine_handle <> Handle {};
+			std::shared_ptr <OffloadState> State {};
+		};
+
+		/// <summary>
+		///		Worker pool, workers share it, so an abandoned one which returns after the executor is gone doesn't touch freed memory
+		/// </summary>
+		struct WorkerPool
+		{
+			std::mutex Mutex {};
+			std::condition_variable Queued {};
+			std::deque <Job> Jobs {};
+			size_t Active {};
+			size_t Abandoned {};
+			bool bStop {};
+		};
+
+		/// <summary>
+		///		Queue call and start a worker if the pool isn't full yet
+		/// </summary>
+		/// 
+		/// <param name="Queued">Call</param>
+		void Submit(Job Queued)
+		{
+			{
+				std::lock_guard <std::mutex> Lock(Pool->Mutex);
+
+				Pool->Jobs.push_back(std::move(Queued));
+				Grow();
+			}
+
+			Pool->Queued.notify_one();
+		}
+
+		/// <summary>
+		///		Start a worker if calls are queued and neither workers nor abandoned workers are at their limit, the pool mutex is held
+		/// </summary>
+		void Grow()
+		{
+			if (Pool->Jobs.size() && Pool->Active < OFFLOAD_WORKERS && Pool->Active + Pool->Abandoned < OFFLOAD_WORKERS + OFFLOAD_ABANDONED_WORKERS)
+			{
+				Pool->Active++;
+				std::thread(&Executor::Work, Pool, this).detach();
+			}
+		}
+
+		/// <summary>
+		///		Give up the worker running the call whose deadline passed, a new worker takes its place
+		/// </summary>
+		/// 
+		/// <param name="State">Call state</param>
+		void Abandon(OffloadState& State)
+		{
+			std::lock_guard <std::mutex> Lock(Pool->Mutex);
+
+			// Queued call is dropped by the worker which takes it
+			if (!State.bStarted)
+			{
+				return;
+			}
+
+			State.bAbandoned = true;
+			Pool->Active--;
+			Pool->Abandoned++;
+			Grow();
+		}
+
+		/// <summary>
+		///		Worker thread
+		/// </summary>
+		/// 
+		/// <param name="Pool">Worker pool</param>
+		/// <param name="Loop">Executor resuming coroutines of finished calls</param>
+		static void Work(std::shared_ptr <WorkerPool> Pool, Executor* Loop)
+		{
+			std::unique_lock <std::mutex> Lock(Pool->Mutex);
+
+			for (;;)
+			{
+				Pool->Queued.wait(Lock, [&]() { return Pool->bStop || Pool->Jobs.size(); });
+
+				if (Pool->Jobs.empty())
+				{
+					Pool->Active--;
+					return;
+				}
+
+				Job Next { std::move(Pool->Jobs.front()) };
+				Pool->Jobs.pop_front();
+
+				auto State { std::move(Next.State) };
+				bool bRun { !State->bClaimed.load(std::memory_order_acquire) };
+
+				State->bStarted = bRun;
+				Lock.unlock();
+
+				if (bRun)
+				{
+					Next.Call();
+
+					if (!State->bClaimed.exchange(true, std::memory_order_acq_rel))
+					{
+						State->bFinished.store(true, std::memory_order_release);
+						Loop->Post(Next.Handle, Clock::now());
+					}
+				}
+
+				// Captured state is released outside the lock
+				Next.Call = nullptr;
+				Lock.lock();
+
+				// Replaced worker stays only if the pool is short of workers, e.g. abandoned workers were at their limit
+				if (State->bAbandoned)
+				{
+					Pool->Abandoned--;
+
+					if (Pool->bStop || Pool->Active >= OFFLOAD_WORKERS)
+					{
+						return;
+					}
+
+					Pool->Active++;
+				}
+			}
+		}
+
+		/// <summary>
+		///		Start task on the loop thread and signal the waiting thread when it finishes
+		/// </summary>
+		template <typename T>
+		Detached Drive(Task <T>& Started, std::mutex& Done, std::condition_variable& Finished, std::exception_ptr& Error, bool& bFinished, T* Result = nullptr)
+		{
+			co_await Schedule();
+
+			try
+			{
+				if constexpr (std::is_void_v <T>)
+				{
+					co_await Started;
+				}
+				else
+				{
+					*Result = co_await Started;
+				}
+			}
+			catch (...)
+			{
+				Error = std::current_exception();
+			}
+
+			std::lock_guard <std::mutex> Lock(Done);
+			bFinished = true;
+			Finished.notify_one();
+		}
+
+		/// <summary>
+		///		Queue coroutine to be resumed on the loop thread
+		/// </summary>
+		/// 
+		/// <param name="Handle">Coroutine</param>
+		/// <param name="Time">Time to resume it</param>
+		/// <param name="Claim">Offloaded call raced by the timer, the coroutine isn't resumed if the call claimed it</param>
+		void Post(std::coroutine_handle <> Handle, Clock::time_point Time, std::shared_ptr <OffloadState> Claim = {})
+		{
+			{
+				std::lock_guard <std::mutex> Lock(Mutex);
+
+				if (!Loop.joinable())
+				{
+					Loop = std::thread(&Executor::RunLoop, this);
+				}
+
+				// Timers are few, so they're kept sorted by insertion
+				auto Position { Timers.begin() };
+
+				while (Position != Timers.end() && Position->Time <= Time)
+				{
+					Position++;
+				}
+
+				Timers.insert(Position, Timer { Time, Handle, std::move(Claim) });
+			}
+
+			Ready.notify_all();
+		}
+
+		/// <summary>
+		///		Loop thread
+		/// </summary>
+		void RunLoop()
+		{
+			std::unique_lock <std::mutex> Lock(Mutex);
+
+			for (;;)
+			{
+				// Deadline of a call which finished in time isn't waited for
+				if (Timers.size() && Timers.front().Claim && Timers.front().Claim->bClaimed.load(std::memory_order_acquire))
+				{
+					Timers.pop_front();
+					continue;
+				}
+
+				if (bStop)
+				{
+					Timers.erase(std::remove_if(Timers.begin(), Timers.end(), [](const Timer& Pending) {
+						return Pending.Claim && Pending.Claim->bClaimed.load(std::memory_order_acquire);
+					}), Timers.end());
+
+					if (Timers.empty())
+					{
+						return;
+					}
+				}
+
+				if (Timers.empty())
+				{
+					Ready.wait(Lock);
+					continue;
+				}
+
+				if (Timers.front().Time > Clock::now())
+				{
+					Ready.wait_until(Lock, Timers.front().Time);
+					continue;
+				}
+
+				auto Handle { Timers.front().Handle };
+				auto Claim { std::move(Timers.front().Claim) };
+				Timers.pop_front();
+
+				// Offloaded call finished meanwhile and resumed the coroutine itself
+				if (Claim && Claim->bClaimed.exchange(true, std::memory_order_acq_rel))
+				{
+					continue;
+				}
+
+				Lock.unlock();
+
+				if (Claim)
+				{
+					Abandon(*Claim);
+				}
+
+				Handle.resume();
+				Lock.lock();
+			}
+		}
+
+		std::deque <Timer> Timers {};
+		std::shared_ptr <WorkerPool> Pool { std::make_shared <WorkerPool>() };
+		std::thread Loop {};
+		std::mutex Mutex {};
+		std::condition_variable Ready {};
+		bool bStop {};
+	};
+}
@@ -0,0 +1,534 @@
+#pragma once
+
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <windows.h>
+#include "../Api/fields.h"
+
+#define BINARY_MAGIC 0x50534E43
+#define BINARY_VERSION 1
+#define BINARY_SLOT_SIZE 8
+
+/// <summary>
+///		Versioned binary inventory snapshot, it's read in place from memory-mapped file.
+///		Layout is header, categories table, fields table, records and UTF-16 string pool, offsets are counted from the file start.
+///		Every field takes 8 bytes at fixed offset of fixed size record, text is (offset, length) slice of the pool.
+///		Categories and fields are described by name, so readers skip unknown ones and keep defaults for missing ones
+/// </summary>
+class BinarySnapshot
+{
+
+public:
+
+	/// <summary>
+	///		File header, HeaderSize lets newer versions append members
+	/// </summary>
+	struct Header
+	{
+		unsigned int Magic {};
+		unsigned int Version {};
+		unsigned int HeaderSize {};
+		unsigned int CategoryCount {};
+		unsigned int CategoriesOffset {};
+		unsigned int PoolOffset {};
+		unsigned int PoolSize {};
+		unsigned int Reserved {};
+		long long Timestamp {};
+	};
+
+	/// <summary>
+	///		Categories table entry
+	/// </summary>
+	struct CategoryEntry
+	{
+		unsigned int Name {};
+		unsigned int NameLength {};
+		unsigned int FieldCount {};
+		unsigned int FieldsOffset {};
+		unsigned int RecordCount {};
+		unsigned int RecordSize {};
+		unsigned int RecordsOffset {};
+		unsigned int Reserved {};
+	};
+
+	/// <summary>
+	///		Fields table entry, Offset is counted from the record start
+	/// </summary>
+	struct FieldEntry
+	{
+		unsigned int Name {};
+		unsigned int NameLength {};
+		unsigned int Format {};
+		unsigned int Offset {};
+	};
+
+	/// <summary>
+	///		Destructor
+	/// </summary>
+	~BinarySnapshot()
+	{
+		Close();
+	}
+
+	/// <summary>
+	///		Write inventory snapshot, equal strings are stored once
+	/// </summary>
+	/// 
+	/// <param name="Statistics">Inventory</param>
+	/// <param name="Path">File</param>
+	/// <param name="Timestamp">Time of the snapshot in seconds</param>
+	/// 
+	/// <returns>bool</returns>
+	static bool Save(const ComputerStatistics& Statistics, const std::wstring& Path, long long Timestamp)
+	{
+		std::string Buffer {};
+		std::wstring Pool {};
+		std::unordered_map <std::wstring, unsigned int> Strings {};
+		Header FileHeader {};
+		size_t FieldCount {};
+
+		auto Intern { [&](const std::wstring& String) {
+			auto Inserted { Strings.try_emplace(String, (unsigned int)Pool.size()) };
+
+			if (Inserted.second)
+			{
+				Pool.append(String);
+			}
+
+			return Inserted.first->second;
+		} };
+
+		for (auto& Category : Fields::Categories)
+		{
+			FieldCount += Category.Fields.size();
+		}
+
+		FileHeader.Magic = BINARY_MAGIC;
+		FileHeader.Version = BINARY_VERSION;
+		FileHeader.HeaderSize = sizeof(Header);
+		FileHeader.CategoryCount = (unsigned int)Fields::Categories.size();
+		FileHeader.CategoriesOffset = sizeof(Header);
+		FileHeader.Timestamp = Timestamp;
+
+		// Tables go first, records follow them
+		size_t FieldsOffset { FileHeader.CategoriesOffset + Fields::Categories.size() * sizeof(CategoryEntry) };
+		Buffer.resize(FieldsOffset + FieldCount * sizeof(FieldEntry));
+
+		for (size_t i = 0; i < Fields::Categories.size(); i++)
+		{
+			auto& Category { Fields::Categories.at(i) };
+			CategoryEntry Entry {};
+
+			Entry.Name = Intern(Category.Name);
+			Entry.NameLength = (unsigned int)Category.Name.size();
+			Entry.FieldCount = (unsigned int)Category.Fields.size();
+			Entry.FieldsOffset = (unsigned int)FieldsOffset;
+			Entry.RecordCount = (unsigned int)Category.Count(Statistics);
+			Entry.RecordSize = (unsigned int)(Category.Fields.size() * BINARY_SLOT_SIZE);
+			Entry.RecordsOffset = (unsigned int)Buffer.size();
+
+			for (size_t j = 0; j < Category.Fields.size(); j++)
+			{
+				auto& Field { Category.Fields.at(j) };
+				FieldEntry Descriptor { Intern(Field.Name), (unsigned int)Field.Name.size(), (unsigned int)Field.Format, (unsigned int)(j * BINARY_SLOT_SIZE) };
+
+				memcpy(&Buffer.at(FieldsOffset), &Descriptor, sizeof(Descriptor));
+				FieldsOffset += sizeof(Descriptor);
+			}
+
+			for (size_t j = 0; j < Entry.RecordCount; j++)
+			{
+				const void* Record { Category.Record(Statistics, j) };
+
+				for (auto& Field : Category.Fields)
+				{
+					Fields::Value FieldValue { Field.Get(Record) };
+					char Slot[BINARY_SLOT_SIZE] {};
+
+					switch (Field.Format)
+					{
+					case Fields::eText:
+					{
+						unsigned int Text[2] { Intern(*FieldValue.String), (unsigned int)FieldValue.String->size() };
+						memcpy(Slot, Text, sizeof(Text));
+					} break;
+
+					case Fields::eReal:
+					{
+						double Real { FieldValue.Real };
+						memcpy(Slot, &Real, sizeof(Real));
+					} break;
+
+					case Fields::eResolution:
+					{
+						int Resolution[2] { (int)FieldValue.Integer, (int)FieldValue.Second };
+						memcpy(Slot, Resolution, sizeof(Resolution));
+					} break;
+
+					default:
+					{
+						memcpy(Slot, &FieldValue.Integer, sizeof(FieldValue.Integer));
+					} break;
+					}
+
+					Buffer.append(Slot, sizeof(Slot));
+				}
+			}
+
+			memcpy(&Buffer.at(FileHeader.CategoriesOffset + i * sizeof(CategoryEntry)), &Entry, sizeof(Entry));
+		}
+
+		FileHeader.PoolOffset = (unsigned int)Buffer.size();
+		FileHeader.PoolSize = (unsigned int)Pool.size();
+		memcpy(&Buffer.at(0), &FileHeader, sizeof(FileHeader));
+
+		Buffer.append((const char*)Pool.data(), Pool.size() * sizeof(wchar_t));
+
+		std::ofstream File(Path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+
+		return File.write(Buffer.data(), Buffer.size()).good();
+	}
+
+	/// <summary>
+	///		Map snapshot file and match its tables with fields registry
+	/// </summary>
+	/// 
+	/// <param name="Path">File</param>
+	/// 
+	/// <returns>bool, false if the file is missing, damaged or has unknown version</returns>
+	bool Open(const std::wstring& Path)
+	{
+		LARGE_INTEGER FileSize {};
+
+		Close();
+
+		File = CreateFileW(Path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+		if (File == INVALID_HANDLE_VALUE || !GetFileSizeEx(File, &FileSize) || FileSize.QuadPart < sizeof(Header)
+			|| !(Mapping = CreateFileMappingW(File, nullptr, PAGE_READONLY, 0, 0, nullptr))
+			|| !(Base = (const char*)MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0)))
+		{
+			Close();
+			return false;
+		}
+
+		Size = (size_t)FileSize.QuadPart;
+		memcpy(&FileHeader, Base, sizeof(FileHeader));
+
+		if (FileHeader.Magic != BINARY_MAGIC || FileHeader.Version != BINARY_VERSION || FileHeader.HeaderSize < sizeof(Header)
+			|| !IsInside(FileHeader.PoolOffset, (size_t)FileHeader.PoolSize * sizeof(wchar_t))
+			|| !IsInside(FileHeader.CategoriesOffset, (size_t)FileHeader.CategoryCount * sizeof(CategoryEntry)))
+		{
+			Close();
+			return false;
+		}
+
+		Pool = std::wstring_view((const wchar_t*)(Base + FileHeader.PoolOffset), FileHeader.PoolSize);
+		Categories.assign(Fields::Categories.size(), {});
+
+		for (unsigned int i = 0; i < FileHeader.CategoryCount; i++)
+		{
+			CategoryEntry Entry {};
+			memcpy(&Entry, Base + FileHeader.CategoriesOffset + i * sizeof(CategoryEntry), sizeof(Entry));
+
+			if (!IsInside(Entry.FieldsOffset, (size_t)Entry.FieldCount * sizeof(FieldEntry))
+				|| !IsInside(Entry.RecordsOffset, (size_t)Entry.RecordCount * Entry.RecordSize))
+			{
+				Close();
+				return false;
+			}
+
+			// Unknown categories are skipped
+			for (size_t j = 0; j < Fields::Categories.size(); j++)
+			{
+				auto& Category { Fields::Categories.at(j) };
+
+				if (GetString(Entry.Name, Entry.NameLength) != Category.Name)
+				{
+					continue;
+				}
+
+				Categories.at(j) = { Entry.RecordCount, Entry.RecordSize, Entry.RecordsOffset, std::vector <unsigned int>(Category.Fields.size(), NONE) };
+
+				for (unsigned int k = 0; k < Entry.FieldCount; k++)
+				{
+					FieldEntry Descriptor {};
+					memcpy(&Descriptor, Base + Entry.FieldsOffset + k * sizeof(FieldEntry), sizeof(Descriptor));
+
+					for (size_t l = 0; l < Category.Fields.size(); l++)
+					{
+						// Field with changed format is treated as missing
+						if (GetString(Descriptor.Name, Descriptor.NameLength) == Category.Fields.at(l).Name && Descriptor.Format == Category.Fields.at(l).Format
+							&& (size_t)Descriptor.Offset + BINARY_SLOT_SIZE <= Entry.RecordSize)
+						{
+							Categories.at(j).Slots.at(l) = Descriptor.Offset;
+						}
+					}
+				}
+			}
+		}
+
+		return true;
+	}
+
+	/// <summary>
+	///		Unmap and close snapshot file
+	/// </summary>
+	void Close()
+	{
+		if (Base)
+		{
+			UnmapViewOfFile(Base);
+			Base = nullptr;
+		}
+
+		if (Mapping)
+		{
+			CloseHandle(Mapping);
+			Mapping = nullptr;
+		}
+
+		if (File != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(File);
+			File = INVALID_HANDLE_VALUE;
+		}
+
+		Categories.clear();
+		Size = 0;
+	}
+
+	/// <summary>
+	///		Get time of the snapshot
+	/// </summary>
+	/// 
+	/// <returns>long long, seconds</returns>
+	long long GetTimestamp() const
+	{
+		return FileHeader.Timestamp;
+	}
+
+	/// <summary>
+	///		Get records count of category
+	/// </summary>
+	/// 
+	/// <param name="Category">Category index in fields registry</param>
+	/// 
+	/// <returns>size_t</returns>
+	size_t Count(size_t Category) const
+	{
+		return Categories.at(Category).RecordCount;
+	}
+
+	/// <summary>
+	///		Read text field in place
+	/// </summary>
+	/// 
+	/// <param name="Category">Category index in fields registry</param>
+	/// <param name="Record">Record index</param>
+	/// <param name="Field">Field index in fields registry</param>
+	/// 
+	/// <returns>std::wstring_view, empty if the field isn't stored</returns>
+	std::wstring_view GetText(size_t Category, size_t Record, size_t Field) const
+	{
+		unsigned int Text[2] {};
+
+		return ReadSlot(Category, Record, Field, Text) ? GetString(Text[0], Text[1]) : std::wstring_view {};
+	}
+
+	/// <summary>
+	///		Read integer, yes/no or media type field
+	/// </summary>
+	/// 
+	/// <param name="Category">Category index in fields registry</param>
+	/// <param name="Record">Record index</param>
+	/// <param name="Field">Field index in fields registry</param>
+	/// 
+	/// <returns>long long, 0 if the field isn't stored</returns>
+	long long GetInteger(size_t Category, size_t Record, size_t Field) const
+	{
+		long long Integer {};
+
+		ReadSlot(Category, Record, Field, Integer);
+
+		return Integer;
+	}
+
+	/// <summary>
+	///		Read real field
+	/// </summary>
+	/// 
+	/// <param name="Category">Category index in fields registry</param>
+	/// <param name="Record">Record index</param>
+	/// <param name="Field">Field index in fields registry</param>
+	/// 
+	/// <returns>double, 0 if the field isn't stored</returns>
+	double GetReal(size_t Category, size_t Record, size_t Field) const
+	{
+		double Real {};
+
+		ReadSlot(Category, Record, Field, Real);
+
+		return Real;
+	}
+
+	/// <summary>
+	///		Read resolution field
+	/// </summary>
+	/// 
+	/// <param name="Category">Category index in fields registry</param>
+	/// <param name="Record">Record index</param>
+	/// <param name="Field">Field index in fields registry</param>
+	/// 
+	/// <returns>std::pair <int, int>, width and height</returns>
+	std::pair <int, int> GetResolution(size_t Category, size_t Record, size_t Field) const
+	{
+		int Resolution[2] {};
+
+		ReadSlot(Category, Record, Field, Resolution);
+
+		return { Resolution[0], Resolution[1] };
+	}
+
+	/// <summary>
+	///		Copy snapshot into inventory, records are appended to list categories
+	/// </summary>
+	/// 
+	/// <param name="Statistics">Inventory</param>
+	void Load(ComputerStatistics& Statistics) const
+	{
+		std::wstring Text {};
+
+		for (size_t i = 0; i < Categories.size(); i++)
+		{
+			auto& Category { Fields::Categories.at(i) };
+
+			for (size_t j = 0; j < Count(i); j++)
+			{
+				void* Record { Category.Insert(Statistics) };
+
+				for (size_t k = 0; k < Category.Fields.size(); k++)
+				{
+					auto& Field { Category.Fields.at(k) };
+
+					if (Categories.at(i).Slots.at(k) == NONE)
+					{
+						continue;
+					}
+
+					switch (Field.Format)
+					{
+					case Fields::eText:
+					{
+						Text.assign(GetText(i, j, k));
+						Field.Set(Record, Fields::Value(Text));
+					} break;
+
+					case Fields::eReal:
+					{
+						Field.Set(Record, Fields::Value((float)GetReal(i, j, k)));
+					} break;
+
+					case Fields::eResolution:
+					{
+						auto Resolution { GetResolution(i, j, k) };
+						Fields::Value FieldValue { Resolution.first };
+
+						FieldValue.Second = Resolution.second;
+						Field.Set(Record, FieldValue);
+					} break;
+
+					default:
+					{
+						Field.Set(Record, Fields::Value(GetInteger(i, j, k)));
+					} break;
+					}
+				}
+			}
+		}
+	}
+
+private:
+
+	static constexpr unsigned int NONE { (unsigned int)-1 };
+
+	/// <summary>
+	///		Category of the file matched with fields registry
+	/// </summary>
+	struct MappedCategory
+	{
+		unsigned int RecordCount {};
+		unsigned int RecordSize {};
+		unsigned int RecordsOffset {};
+
+		// Slot offsets in registry fields order, NONE if the file doesn't have the field
+		std::vector <unsigned int> Slots {};
+	};
+
+	/// <summary>
+	///		Check that range lies in the file
+	/// </summary>
+	/// 
+	/// <param name="Offset">Offset</param>
+	/// <param name="Length">Length in bytes</param>
+	/// 
+	/// <returns>bool</returns>
+	bool IsInside(size_t Offset, size_t Length) const
+	{
+		return Offset <= Size && Length <= Size - Offset;
+	}
+
+	/// <summary>
+	///		Get pool string
+	/// </summary>
+	/// 
+	/// <param name="Offset">Offset in symbols</param>
+	/// <param name="Length">Length in symbols</param>
+	/// 
+	/// <returns>std::wstring_view, empty if the string is out of the pool</returns>
+	std::wstring_view GetString(unsigned int Offset, unsigned int Length) const
+	{
+		return Offset <= Pool.size() && Length <= Pool.size() - Offset ? Pool.substr(Offset, Length) : std::wstring_view {};
+	}
+
+	/// <summary>
+	///		Copy field slot
+	/// </summary>
+	/// 
+	/// <typeparam name="T">Slot type</typeparam>
+	/// <param name="Category">Category index in fields registry</param>
+	/// <param name="Record">Record index</param>
+	/// <param name="Field">Field index in fields registry</param>
+	/// <param name="Result">Slot value</param>
+	/// 
+	/// <returns>bool, false if the field isn't stored</returns>
+	template <typename T>
+	bool ReadSlot(size_t Category, size_t Record, size_t Field, T& Result) const
+	{
+		static_assert(sizeof(T) <= BINARY_SLOT_SIZE);
+
+		auto& Mapped { Categories.at(Category) };
+
+		if (Record >= Mapped.RecordCount || Mapped.Slots.at(Field) == NONE)
+		{
+			return false;
+		}
+
+		memcpy(&Result, Base + Mapped.RecordsOffset + Record * Mapped.RecordSize + Mapped.Slots.at(Field), sizeof(T));
+
+		return true;
+	}
+
+	std::vector <MappedCategory> Categories {};
+	std::wstring_view Pool {};
+	Header FileHeader {};
+	HANDLE File { INVALID_HANDLE_VALUE };
+	HANDLE Mapping {};
+	const char* Base {};
+	size_t Size {};
+};
@@ -4,12 +4,33 @@
 #include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <winsock2.h>
 #include <windows.h>
 #include <chrono>
 #include <ctime>
 #include <thread>
 #include <vector>
 #include "../Api/comstat.h"
+#include "../Api/aggregate.h"
+#include "../Api/alert.h"
+#include "../Api/binary.h"
+#include "../Api/compress.h"
+#include "../Api/console.h"
+#include "../Api/dashboard.h"
+#include "../Api/diff.h"
+#include "../Api/fields.h"
+#include "../Api/hotplug.h"
+#include "../Api/intern.h"
+#include "../Api/metrics.h"
+#include "../Api/overhead.h"
+#include "../Api/parser.h"
+#include "../Api/pipe.h"
+#include "../Api/query.h"
+#include "../Api/report.h"
+#include "../Api/rotate.h"
+#include "../Api/serializer.h"
+#include "../Api/snapshot.h"
+#include "../Api/trace.h"
 
 #define FOREGROUND_WHITE 0x0007
 #define VK_Z 0x5A
@@ -18,8 +39,15 @@
 #define HELP_FILE L"web\\index.html"
 #define LOG_FILE L"logs\\log.csv"
 #define STATISTICS_FILE L"logs\\statistics.csv"
+#define SNAPSHOT_FILE L"logs\\statistics.bin"
+#define ALERTS_LOG_FILE L"logs\\alerts.csv"
+#define ALERTS_FILE L"alerts.txt"
+#define SCRIPT_FLUSH_SIZE 65536
+#define METRICS_PORT 9182
+#define METRICS_REFRESH_INTERVAL 5
+#define PIPE_POLL_INTERVAL 250
 
-std::ofstream statisticsFile;
+LogStream statisticsFile;
 
 /// <summary>
 ///		CommandLine 
@@ -27,8 +55,21 @@ std::ofstream statisticsFile;
 namespace CommandLine 
 {
 	// Initialization
-	ComputerStatistics HWID {};
+	ComputerStatistics HWID { ComputerStatistics::eQueryNone };
+	AlertEngine Alerts {};
+	ConsoleOutput Console {};
+	DeviceWatcher Devices {};
+	LogRotation Rotation {};
+	Serializer Output {};
+	int OutputFormat { Serializer::eText };
 	std::wstring CurCmd { L"" };
+	bool bCompress {};
+	std::wstring TracePath {};
+	unsigned int Requests {};
+	std::wstring FieldText {};
+	Query Filter {};
+	std::vector <size_t> Rows {};
+	std::string SaveText {};
 	std::wstring AppName { L"   ______                            __               \n"
 						  L"  / ____/___  ____ ___  ____  __  __/ /____  _____    \n"
 						  L" / /   / __ \\/ __ `__ \\/ __ \\/ / / / __/ _ \\/ ___/\n"
@@ -62,6 +103,12 @@ namespace CommandLine
 		eMusicOn,
 		eMusicOff,
 		eSave,
+		eServe,
+		ePublish,
+		eListen,
+		eDiff,
+		eAggregate,
+		eLoad,
 		eHelp,
 		eExit
 	};
@@ -85,112 +132,39 @@ namespace CommandLine
 		L"musicon",
 		L"musicoff",
 		L"save",
+		L"serve",
+		L"publish",
+		L"listen",
+		L"diff",
+		L"aggregate",
+		L"load",
 		L"help",
 		L"exit"
 	};
 
 	/// <summary>
-	///		Valid disks sub commands name
+	///		Commands lookup table
 	/// </summary>
-	std::vector <std::wstring> DiskSubCommands
-	{
-		L"invalid command",
-		L"serialnumber",
-		L"model",
-		L"interface",
-		L"driveletter",
-		L"size",
-		L"freespace",
-		L"mediatype",
-		L"isbootdrive"
-	};
-
-	/// <summary>
-	///		Valid SMBIOS sub commands name
-	/// </summary>
-	std::vector <std::wstring> SMBIOSSubCommands
-	{
-		L"invalid command",
-		L"serialnumber",
-		L"manufacturer",
-		L"product",
-		L"version"
-	};
-
-	/// <summary>
-	///		Valid GPU sub commands name
-	/// </summary>
-	std::vector <std::wstring> GPUSubCommands
-	{
-		L"invalid command",
-		L"name",
-		L"driverversion",
-		L"resolution",
-		L"refreshrate"
-	};
-
-	/// <summary>
-	///		Valid CPU sub commands name
-	/// </summary>
-	std::vector <std::wstring> CPUSubCommands
-	{
-		L"invalid command",
-		L"processorid",
-		L"manufacturer",
-		L"name",
-		L"cores",
-		L"threads"
-	};
+	KeywordTable <32> CommandKeywords { ValidCommands };
 
-	/// <summary>
-	///		Valid network sub commands name
-	/// </summary>
-	std::vector <std::wstring> NetworkSubCommands
-	{
-		L"invalid command",
-		L"name",
-		L"mac"
-	};
+	static_assert(eExit <= decltype(CommandKeywords)::Capacity, "Commands don't fit in the lookup table");
 
 	/// <summary>
-	///		Valid OS sub commands name
+	///		Sub commands lookup tables, one per category
 	/// </summary>
-	std::vector <std::wstring> SystemSubCommands
-	{
-		L"invalid command",
-		L"name",
-		L"ishypervisorpresent",
-		L"osversion",
-		L"ostitle",
-		L"osarchitecture",
-		L"osserialnumber"
-	};
+	std::vector <KeywordTable <16>> SubCommandKeywords { [] {
+		std::vector <KeywordTable <16>> Tables(Fields::Categories.size());
 
-	/// <summary>
-	///		Valid memory sub commands name
-	/// </summary>
-	std::vector <std::wstring> PhysicalMemorySubCommands
-	{
-		L"invalid command",
-		L"partnumber",
-		L"totalsize",
-		L"availablesize",
-		L"totalvirtualsize",
-		L"availablevirtualsize",
-		L"totalpagefilesize",
-		L"availablepagefilesize",
-	};
+		for (int i = 0; i < Fields::Categories.size(); i++) 
+		{
+			for (int j = 0; j < Fields::Categories.at(i).Fields.size(); j++) 
+			{
+				Tables.at(i).Add(Fields::Categories.at(i).Fields.at(j).Name, j + 1);
+			}
+		}
 
-	/// <summary>
-	///		Valid registry sub commands name
-	/// </summary>
-	std::vector <std::wstring> RegistrySubCommands
-	{
-		L"invalid command",
-		L"computerhardwareid",
-		L"computermanufacturer",
-		L"computerproductname",
-	};
+		return Tables;
+	}() };
 
 	/// <summary>
 	///		Container for commands
@@ -199,999 +173,1372 @@ namespace CommandLine
 	{
 		int CommandIndex {};
 		std::vector <int> SubCommandIndex {};
+		unsigned short Port { METRICS_PORT };
+		std::vector <std::wstring> Files {};
 	} ParsedCommand;
 
 	/// <summary>
-	///		Iteration output
+	///		Decode UTF-8 text of saved statistics, e.g. disk models and values of "diff" and "aggregate"
 	/// </summary>
 	/// 
-	/// <typeparam name="T">Type</typeparam>
-	/// <param name="ToPrint">Values</param>
-	/// <param name="HWType">HW type</param>
-	/// <param name="Iterator">Iterator</param>
-	template <typename T>
-	void FmtPrint(T ToPrint, int HWType, int Iterator) 
+	/// <param name="Text">UTF-8 text</param>
+	/// 
+	/// <returns>std::wstring</returns>
+	std::wstring FromUTF8(std::string_view Text) 
 	{
-		std::wcout << ToPrint;
-
-		// Available for disks, GPU and network
-		switch (HWType) 
-		{
-		case eDisk: 
+		if (Text.empty()) 
 		{
-			std::wcout << (Iterator && Iterator + 1 == HWID.Disk.size() ? L"\n\n" : L"\n");
-		} break;
+			return {};
+		}
 
-		case eGPU: 
-		{
-			std::wcout << (Iterator && Iterator + 1 == HWID.GPU.size() ? L"\n\n" : L"\n");
-		} break;
+		std::wstring Result(MultiByteToWideChar(CP_UTF8, 0, Text.data(), (int)Text.size(), nullptr, 0), L' ');
 
-		case eNetwork: 
-		{
-			std::wcout << (Iterator && Iterator + 1 == HWID.NetworkAdapter.size() ? L"\n\n" : L"\n");
-		} break;
-		}
+		MultiByteToWideChar(CP_UTF8, 0, Text.data(), (int)Text.size(), Result.data(), (int)Result.size());
+
+		return Result;
 	}
 
 	/// <summary>
-	///		Print disks information
+	///		Get category of the parsed command
 	/// </summary>
-	void PrintDisks() 
+	/// 
+	/// <returns>const Fields::Category*</returns>
+	const Fields::Category* ParsedCategory() 
 	{
-		for (int i = 0; i < HWID.Disk.size(); i++) 
+		if (ParsedCommand.CommandIndex < eDisk || ParsedCommand.CommandIndex > eRegistry) 
 		{
-			std::wcout << L"Model:\t\t\t" << HWID.Disk.at(i).Model << std::endl;
-			std::wcout << L"Serial Number:\t\t" << HWID.Disk.at(i).SerialNumber << std::endl;
-			std::wcout << L"Interface Type:\t\t" << HWID.Disk.at(i).Interface << std::endl;
-			std::wcout << L"Drive Letter:\t\t" << HWID.Disk.at(i).DriveLetter << std::endl;
-			std::wcout << L"Size:\t\t\t" << HWID.Disk.at(i).Size << L" GB" << std::endl;
-			std::wcout << L"Free Space:\t\t" << HWID.Disk.at(i).FreeSpace << L" GB" << std::endl;
-			std::wcout << L"Media Type:\t\t" << (HWID.Disk.at(i).MediaType == 4 ? L"SSD" : (HWID.Disk.at(i).MediaType == 3 ? L"HDD" : L"")) << std::endl;
-			std::wcout << L"Boot Drive:\t\t" << (HWID.Disk.at(i).IsBootDrive ? L"Yes" : L"No") << std::endl;
-
-			if (i + 1 < HWID.Disk.size()) 
-			{ 
-				std::wcout << std::endl; 
-			}
+			return nullptr;
 		}
+
+		return &Fields::Categories.at(ParsedCommand.CommandIndex - eDisk);
 	}
 
 	/// <summary>
-	///		Print SMBIOS information
+	///		Format field value of the record into FieldText
 	/// </summary>
-	void PrintSMBIOS() 
+	/// 
+	/// <param name="Field">Field</param>
+	/// <param name="Record">Record</param>
+	/// 
+	/// <returns>const std::wstring&</returns>
+	const std::wstring& FormatField(const Fields::Field& Field, const void* Record) 
 	{
-		std::wcout << L"Manufacturer:\t\t" << HWID.SMBIOS.Manufacturer << std::endl;
-		std::wcout << L"Product:\t\t" << HWID.SMBIOS.Product << std::endl;
-		std::wcout << L"Version:\t\t" << HWID.SMBIOS.Version << std::endl;
-		std::wcout << L"Serial Number:\t\t" << HWID.SMBIOS.SerialNumber << std::endl;
+		return Report::FormatField(Field, Record, FieldText);
 	}
 
 	/// <summary>
-	///		Print GPU information
+	///		Print staleness marker if category wasn't collected completely
 	/// </summary>
-	void PrintGPUs() 
+	/// 
+	/// <param name="Category">Category</param>
+	void PrintStale(const Fields::Category& Category) 
 	{
-		for (int i = 0; i < HWID.GPU.size(); i++) 
+		if (HWID.IsStale(Category.Query)) 
 		{
-			std::wcout << L"Name:\t\t\t" << HWID.GPU.at(i).Name << std::endl;
-			std::wcout << L"Driver Version:\t\t" << HWID.GPU.at(i).DriverVersion << std::endl;
-			std::wcout << L"Resolution:\t\t" << HWID.GPU.at(i).XResolution << L"x" << HWID.GPU.at(i).YResolution << std::endl;
-			std::wcout << L"Refresh Rate:\t\t" << HWID.GPU.at(i).RefreshRate << std::endl;
+			Console.SetColor(FOREGROUND_RED);
+			Console << L"(incomplete, a query timed out or was cancelled)\n";
+			Console.SetColor(FOREGROUND_WHITE);
+		}
+	}
 
-			if (i + 1 < HWID.GPU.size()) 
-			{ 
-				std::wcout << std::endl; 
-			}
+	/// <summary>
+	///		Console control handler, CTRL + C during collection cancels remaining queries instead of closing the program
+	/// </summary>
+	/// 
+	/// <param name="CtrlType">Control signal</param>
+	/// 
+	/// <returns>BOOL</returns>
+	BOOL WINAPI CancelCollection(DWORD CtrlType) 
+	{
+		if (CtrlType == CTRL_C_EVENT) 
+		{
+			ComputerStatistics::Cancel();
+			return TRUE;
 		}
+
+		return FALSE;
 	}
 
 	/// <summary>
-	///		Print CPU information
+	///		Collect inventory, it's cancellable with CTRL + C
 	/// </summary>
-	void PrintCPU()
+	/// 
+	/// <param name="Categories">Categories flags</param>
+	void CollectInventory(unsigned int Categories) 
 	{
-		std::wcout << L"Processor Id:\t\t" << HWID.CPU.ProcessorId << std::endl;
-		std::wcout << L"Manufacturer:\t\t" << HWID.CPU.Manufacturer << std::endl;
-		std::wcout << L"Name:\t\t\t" << HWID.CPU.Name << std::endl;
-		std::wcout << L"Cores:\t\t\t" << HWID.CPU.Cores << std::endl;
-		std::wcout << L"Threads:\t\t" << HWID.CPU.Threads << std::endl;
+		SetConsoleCtrlHandler(CancelCollection, TRUE);
+		HWID = ComputerStatistics(Categories);
+		SetConsoleCtrlHandler(CancelCollection, FALSE);
 	}
 
 	/// <summary>
-	///		Print network information
+	///		Print selected records of category
 	/// </summary>
-	void PrintNetwork() 
+	/// 
+	/// <param name="Category">Category</param>
+	void PrintCategory(const Fields::Category& Category) 
 	{
-		for (int i = 0; i < HWID.NetworkAdapter.size(); i++) 
+		size_t Column { Fields::LabelColumn(Category) };
+		std::wstring Text {};
+
+		Filter.Select(Category, HWID, Rows);
+
+		for (size_t i = 0; i < Rows.size(); i++) 
 		{
-			std::wcout << L"Name:\t\t\t" << HWID.NetworkAdapter.at(i).Name << std::endl;
-			std::wcout << L"MAC Address:\t\t" << HWID.NetworkAdapter.at(i).MAC << std::endl;
+			Report::AppendRecord(Category, Category.Record(HWID, Rows.at(i)), Column, Text, FieldText);
 
-			if (i + 1 < HWID.NetworkAdapter.size()) 
+			if (i + 1 < Rows.size()) 
 			{ 
-				std::wcout << std::endl; 
+				Text.push_back(L'\n'); 
 			}
 		}
-	}
 
-	/// <summary>
-	///		Print OS information
-	/// </summary>
-	void PrintSystem() 
-	{
-		std::wcout << L"System Name:\t\t" << HWID.System.Name << std::endl;
-		std::wcout << L"Hypervisor Present:\t" << (HWID.System.IsHypervisorPresent ? L"Yes" : L"No") << std::endl;
-		std::wcout << L"OS Version:\t\t" << HWID.System.OSVersion << std::endl;
-		std::wcout << L"OS Title:\t\t" << HWID.System.OSName << std::endl;
-		std::wcout << L"OS Architecture:\t" << HWID.System.OSArchitecture << std::endl;
-		std::wcout << L"OS Serial Number:\t" << HWID.System.OSSerialNumber << std::endl;
-	}
+		Console << Text;
 
-	/// <summary>
-	///		Print memory information
-	/// </summary>
-	void PrintPhysicalMemory() 
-	{
-		std::wcout << L"Part Number:\t\t\t" << HWID.PhysicalMemory.PartNumber << std::endl;
-		std::wcout << L"Total Physical Size:\t\t" << HWID.PhysicalMemory.TotalSize << L" MB" << std::endl;
-		std::wcout << L"Available Physical Size:\t" << HWID.PhysicalMemory.AvailableSize << L" MB" << std::endl;
-		std::wcout << L"Total Virtual Size:\t\t" << HWID.PhysicalMemory.TotalVirtualSize << L" MB" << std::endl;
-		std::wcout << L"Available Virtual Size:\t\t" << HWID.PhysicalMemory.AvailableVirtualSize << L" MB" << std::endl;
-		std::wcout << L"Total Page File Size:\t\t" << HWID.PhysicalMemory.TotalPageSize << L" MB" << std::endl;
-		std::wcout << L"Available Page File Size:\t" << HWID.PhysicalMemory.AvailablePageSize << L" MB" << std::endl;
+		PrintStale(Category);
 	}
 
 	/// <summary>
-	///		Print registry information
+	///		Print requested fields of selected records, values of one field are printed together
 	/// </summary>
-	void PrintRegistry() 
+	/// 
+	/// <param name="Category">Category</param>
+	/// <param name="FieldIndices">Requested sub commands indices</param>
+	void PrintFields(const Fields::Category& Category, const std::vector <int>& FieldIndices) 
 	{
-		std::wcout << L"Computer Hardware Id:\t" << HWID.Registry.ComputerHardwareId << std::endl;
-		std::wcout << L"Computer Manufacturer:\t" << HWID.Registry.ComputerManufacturer << std::endl;
-		std::wcout << L"Computer Product Name:\t" << HWID.Registry.ComputerName << std::endl;
+		Filter.Select(Category, HWID, Rows);
+
+		for (int i = 0; i < FieldIndices.size(); i++) 
+		{
+			auto& Field { Category.Fields.at(FieldIndices.at(i) - 1) };
+
+			// Separate values of several disks, GPUs or adapters
+			if (i && Rows.size() > 1) 
+			{
+				Console << L"\n";
+			}
+
+			for (size_t j = 0; j < Rows.size(); j++) 
+			{
+				Console << FormatField(Field, Category.Record(HWID, Rows.at(j))) << L"\n";
+			}
+		}
+
+		PrintStale(Category);
 	}
 
 	/// <summary>
-	///		Save disks information
+	///		Print compression ratio and speed of closed log
 	/// </summary>
-	void SaveDisks() 
+	/// 
+	/// <param name="Log">Closed log</param>
+	void PrintCompression(LogStream& Log) 
 	{
-		for (int i = 0; i < HWID.Disk.size(); i++) 
+		unsigned long long Raw {};
+		unsigned long long Stored {};
+		double Seconds {};
+
+		Log.GetStatistics(Raw, Stored, Seconds);
+
+		if (Raw) 
 		{
-			statisticsFile << "Model: " << std::string(HWID.Disk.at(i).Model.begin(), HWID.Disk.at(i).Model.end()) << "\n";
-			statisticsFile << "Serial Number: " << std::string(HWID.Disk.at(i).SerialNumber.begin(), HWID.Disk.at(i).SerialNumber.end()) << "\n";
-			statisticsFile << "Interface Type: " << std::string(HWID.Disk.at(i).Interface.begin(), HWID.Disk.at(i).Interface.end()) << "\n";
-			statisticsFile << "Drive Letter: " << std::string(HWID.Disk.at(i).DriveLetter.begin(), HWID.Disk.at(i).DriveLetter.end()) << "\n";
-			statisticsFile << "Size: " << HWID.Disk.at(i).Size << " GB" << "\n";
-			statisticsFile << "Free Space: " << HWID.Disk.at(i).FreeSpace << " GB" << "\n";
-			statisticsFile << "Media Type: " <<(HWID.Disk.at(i).MediaType == 4 ? "SSD" : (HWID.Disk.at(i).MediaType == 3 ? "HDD" : "")) << "\n";
-			statisticsFile << "Boot Drive: " << (HWID.Disk.at(i).IsBootDrive ? "Yes" : "No") << "\n";
-
-			if (i + 1 < HWID.Disk.size()) 
-			{ 
-				statisticsFile << "\n"; 
-			}
+			Console << L"Compressed " << (long long)Raw << L" bytes to " << (long long)Stored << L" bytes (" << (long long)(Stored * 100 / Raw)
+				<< L"%, " << Seconds * 1000 * 1048576 / Raw << L" ms/MB)\n";
 		}
 	}
 
 	/// <summary>
-	///		Save SMBIOS information
+	///		Collect categories changed by hardware hot-plug again
 	/// </summary>
-	void SaveSMBIOS() 
+	/// 
+	/// <returns>bool, true if inventory was collected again</returns>
+	bool RefreshChanged() 
 	{
-		statisticsFile << "Manufacturer: " << std::string(HWID.SMBIOS.Manufacturer.begin(), HWID.SMBIOS.Manufacturer.end()) << "\n";
-		statisticsFile << "Product: " << std::string(HWID.SMBIOS.Product.begin(), HWID.SMBIOS.Product.end()) << "\n";
-		statisticsFile << "Version: " << std::string(HWID.SMBIOS.Version.begin(), HWID.SMBIOS.Version.end()) << "\n";
-		statisticsFile << "Serial Number: " << std::string(HWID.SMBIOS.SerialNumber.begin(), HWID.SMBIOS.SerialNumber.end()) << "\n";
+		unsigned int Changed { Devices.Take() };
+
+		if (Changed == ComputerStatistics::eQueryNone) 
+		{
+			return false;
+		}
+
+		SetConsoleCtrlHandler(CancelCollection, TRUE);
+		HWID.Refresh(Changed);
+		SetConsoleCtrlHandler(CancelCollection, FALSE);
+
+		return true;
 	}
 
 	/// <summary>
-	///		Save GPU information
+	///		Format own footprint of the process
 	/// </summary>
-	void SaveGPUs() 
+	/// 
+	/// <param name="Measured">Overhead</param>
+	/// <param name="Unit">Unit of counts, e.g. "sample"</param>
+	/// 
+	/// <returns>std::string</returns>
+	std::string FormatOverhead(const SelfOverhead::Sample& Measured, const char* Unit) 
 	{
-		for (int i = 0; i < HWID.GPU.size(); i++) 
-		{
-			statisticsFile << "Name: " << std::string(HWID.GPU.at(i).Name.begin(), HWID.GPU.at(i).Name.end()) << "\n";
-			statisticsFile << "Driver Version: " << std::string(HWID.GPU.at(i).DriverVersion.begin(), HWID.GPU.at(i).DriverVersion.end()) << "\n";
-			statisticsFile << "Resolution: " << HWID.GPU.at(i).XResolution << "x" << HWID.GPU.at(i).YResolution << "\n";
-			statisticsFile << "Refresh Rate: " << HWID.GPU.at(i).RefreshRate << "\n";
+		char Text[256] {};
 
-			if (i + 1 < HWID.GPU.size()) 
-			{ 
-				statisticsFile << "\n"; 
-			}
-		}
+		snprintf(Text, sizeof(Text), "ComStat overhead: CPU %.3f%% of one core (%.2f ms/%s), memory %.1f MB, %.1f allocations/%s, %.1f I/O operations/%s",
+			Measured.CPUPercent, Measured.CPUMilliseconds, Unit, Measured.ResidentMB, Measured.Allocations, Unit, Measured.IOOperations, Unit);
+
+		return Text;
 	}
 
 	/// <summary>
-	///		Save CPU information
+	///		Print own footprint of the process, it's red if CPU usage exceeds the budget
 	/// </summary>
-	void SaveCPU() 
+	/// 
+	/// <param name="Text">Formatted overhead</param>
+	/// <param name="Measured">Overhead</param>
+	void PrintOverhead(const std::string& Text, const SelfOverhead::Sample& Measured) 
 	{
-		statisticsFile << "Processor Id: " << std::string(HWID.CPU.ProcessorId.begin(), HWID.CPU.ProcessorId.end()) << "\n";
-		statisticsFile << "Manufacturer: " << std::string(HWID.CPU.Manufacturer.begin(), HWID.CPU.Manufacturer.end()) << "\n";
-		statisticsFile << "Name: " << std::string(HWID.CPU.Name.begin(), HWID.CPU.Name.end()) << "\n";
-		statisticsFile << "Cores: " << HWID.CPU.Cores << "\n";
-		statisticsFile << "Threads: " << HWID.CPU.Threads << "\n";
+		Console.SetColor(SelfOverhead::IsOverBudget(Measured) ? FOREGROUND_RED : FOREGROUND_WHITE);
+		Console << std::wstring(Text.begin(), Text.end()) << L"\n";
+		Console.SetColor(FOREGROUND_WHITE);
 	}
 
 	/// <summary>
-	///		Save network information
+	///		Append selected records of category to save buffer
 	/// </summary>
-	void SaveNetwork() 
+	/// 
+	/// <param name="Category">Category</param>
+	void SaveCategory(const Fields::Category& Category) 
 	{
-		for (int i = 0; i < HWID.NetworkAdapter.size(); i++) 
+		Filter.Select(Category, HWID, Rows);
+
+		for (size_t i = 0; i < Rows.size(); i++) 
 		{
-			statisticsFile << "Name: " << std::string(HWID.NetworkAdapter.at(i).Name.begin(), HWID.NetworkAdapter.at(i).Name.end()) << "\n";
-			statisticsFile << "MAC Address: " << std::string(HWID.NetworkAdapter.at(i).MAC.begin(), HWID.NetworkAdapter.at(i).MAC.end()) << "\n";
+			Report::SaveRecord(Category, Category.Record(HWID, Rows.at(i)), SaveText, FieldText);
 
-			if (i + 1 < HWID.NetworkAdapter.size()) 
+			if (i + 1 < Rows.size()) 
 			{ 
-				statisticsFile << "\n"; 
+				SaveText.push_back('\n'); 
 			}
 		}
 	}
 
 	/// <summary>
-	///		Save OS information
+	///		Serialize selected records of category
 	/// </summary>
-	void SaveSystem() 
+	/// 
+	/// <param name="Category">Category</param>
+	/// <param name="FieldIndices">Requested sub commands indices, all fields if empty</param>
+	void SerializeCategory(const Fields::Category& Category, const std::vector <int>& FieldIndices) 
 	{
-		statisticsFile << "System Name: " << std::string(HWID.System.Name.begin(), HWID.System.Name.end()) << "\n";
-		statisticsFile << "Hypervisor Present: " << (HWID.System.IsHypervisorPresent ? "Yes" : "No") << "\n";
-		statisticsFile << "OS Version: " << std::string(HWID.System.OSVersion.begin(), HWID.System.OSVersion.end()) << "\n";
-		statisticsFile << "OS Title: " << std::string(HWID.System.OSName.begin(), HWID.System.OSName.end()) << "\n";
-		statisticsFile << "OS Architecture: " << std::string(HWID.System.OSArchitecture.begin(), HWID.System.OSArchitecture.end()) << "\n";
-		statisticsFile << "OS Serial Number: " << std::string(HWID.System.OSSerialNumber.begin(), HWID.System.OSSerialNumber.end()) << "\n";
+		Filter.Select(Category, HWID, Rows);
+		Output.BeginCategory(Category.Name, Category.IsList);
+
+		for (size_t i = 0; i < Rows.size(); i++) 
+		{
+			Report::SerializeRecord(Output, Category, Category.Record(HWID, Rows.at(i)), FieldIndices, FieldText);
+		}
+
+		Output.EndCategory();
 	}
 
 	/// <summary>
-	///		Save memory information
+	///		Get valid subcommands lookup table
 	/// </summary>
-	void SavePhysicalMemory() 
+	/// 
+	/// <returns>const KeywordTable <16>*</returns>
+	const KeywordTable <16>* ValidSubCommands() 
 	{
-		statisticsFile << "Part Number: " << std::string(HWID.PhysicalMemory.PartNumber.begin(), HWID.PhysicalMemory.PartNumber.end()) << "\n";
-		statisticsFile << "Total Physical Size: " << HWID.PhysicalMemory.TotalSize << " MB" << "\n";
-		statisticsFile << "Available Physical Size: " << HWID.PhysicalMemory.AvailableSize << " MB" << "\n";
-		statisticsFile << "Total Virtual Size: " << HWID.PhysicalMemory.TotalVirtualSize << " MB" << "\n";
-		statisticsFile << "Available Virtual Size: " << HWID.PhysicalMemory.AvailableVirtualSize << " MB" << "\n";
-		statisticsFile << "Total Page File Size: " << HWID.PhysicalMemory.TotalPageSize << " MB" << "\n";
-		statisticsFile << "Available Page File Size: " << HWID.PhysicalMemory.AvailablePageSize << " MB" << "\n";
+		if (ParsedCommand.CommandIndex < eDisk || ParsedCommand.CommandIndex > eRegistry) 
+		{
+			return nullptr;
+		}
+
+		return &SubCommandKeywords.at(ParsedCommand.CommandIndex - eDisk);
 	}
 
 	/// <summary>
-	///		Save registry information
+	///		Parse category clauses: "get" sub commands, "where" conditions and "order by" field
 	/// </summary>
-	void SaveRegistry() 
+	/// 
+	/// <param name="Tokens">Tokenizer</param>
+	/// <param name="Token">First clause token</param>
+	/// 
+	/// <returns>bool</returns>
+	bool ParseQuery(Tokenizer& Tokens, std::wstring_view Token) 
 	{
-		statisticsFile << "Computer Hardware Id: " << std::string(HWID.Registry.ComputerHardwareId.begin(), HWID.Registry.ComputerHardwareId.end()) << "\n";
-		statisticsFile << "Computer Manufacturer: " << std::string(HWID.Registry.ComputerManufacturer.begin(), HWID.Registry.ComputerManufacturer.end()) << "\n";
-		statisticsFile << "Computer Product Name: " << std::string(HWID.Registry.ComputerName.begin(), HWID.Registry.ComputerName.end()) << "\n";
+		const KeywordTable <16>* SubCommands { ValidSubCommands() };
+
+		if (!SubCommands) 
+		{
+			return false;
+		}
+
+		return Report::ParseQuery(Tokens, Token, *ParsedCategory(), *SubCommands, Filter, ParsedCommand.SubCommandIndex);
 	}
 
 	/// <summary>
-	///		Get valid subcommands
+	///		Parse command, e.g. "disk get model size", "disk get model where freespace < 10 order by freespace" or "real time"
 	/// </summary>
-	/// 
-	/// <returns>std::vector <std::wstring></returns>
-	std::vector <std::wstring> ValidSubCommands() 
+	void ParseCommand() 
 	{
-		switch (ParsedCommand.CommandIndex) 
-		{
-		case eDisk: 
-		{
-			return DiskSubCommands;
-		} break;
-
-		case eSMBIOS: 
-		{
-			return SMBIOSSubCommands;
-		} break;
+		Tokenizer Tokens { CurCmd };
+		std::wstring_view Token {};
+		std::wstring_view NextToken {};
 
-		case eGPU:
-		{
-			return GPUSubCommands;
-		} break;
+		ParsedCommand.CommandIndex = eInvalid;
+		ParsedCommand.SubCommandIndex.clear();
+		ParsedCommand.Port = METRICS_PORT;
+		ParsedCommand.Files.clear();
+		Filter.Clear();
 
-		case eCPU: 
+		if (!Tokens.Next(Token)) 
 		{
-			return CPUSubCommands;
-		} break;
+			return;
+		}
 
-		case eNetwork: 
-		{
-			return NetworkSubCommands;
-		} break;
+		// Main command, it can be written as two words
+		ParsedCommand.CommandIndex = CommandKeywords.Find(Token);
+		bool bNext { Tokens.Next(NextToken) };
 
-		case eSystem: 
+		if (ParsedCommand.CommandIndex == eInvalid && bNext) 
 		{
-			return SystemSubCommands;
-		} break;
+			ParsedCommand.CommandIndex = CommandKeywords.Find(Token, NextToken);
+			bNext = Tokens.Next(NextToken);
+		}
 
-		case ePhysicalMemory: 
+		if (ParsedCommand.CommandIndex == eInvalid || !bNext) 
 		{
-			return PhysicalMemorySubCommands;
-		} break;
+			return;
+		}
 
-		case eRegistry: 
+		// Optional port, e.g. "serve 9100"
+		if (ParsedCommand.CommandIndex == eServe) 
 		{
-			return RegistrySubCommands;
-		} break;
-		}
+			int Port { _wtoi(std::wstring(NextToken).c_str()) };
 
-		return {};
-	}
+			if (Port <= 0 || Port > 65535 || Tokens.Next(Token)) 
+			{
+				ParsedCommand.CommandIndex = eInvalid;
+			}
 
-	/// <summary>
-	///		Parse command
-	/// </summary>
-	void ParseCommand() 
-	{
-		bool bFound { false };
+			ParsedCommand.Port = Port;
+			return;
+		}
 
-		// Order command parts
-		auto OrderVector{ [](std::vector <int> ToOrder) -> std::vector <int> {
-			struct MinToMax 
+		// Statistics files or directory, e.g. "diff old.csv new.csv", "aggregate fleet" or "load old.bin"
+		if (ParsedCommand.CommandIndex == eDiff || ParsedCommand.CommandIndex == eAggregate || ParsedCommand.CommandIndex == eLoad) 
+		{
+			do 
 			{
-				MinToMax(const std::vector <int>& Vector) : _Vector(Vector) {}
-
-				bool operator () (int Index, int Index2) 
+				if (NextToken.size() > 1 && NextToken.front() == L'"' && NextToken.back() == L'"') 
 				{
-					return _Vector[Index] < _Vector[Index2];
+					NextToken = NextToken.substr(1, NextToken.size() - 2);
 				}
 
-				const std::vector <int>& _Vector {};
-			};
-
-			std::vector <int> OrderedElements {};
-			OrderedElements.resize(ToOrder.size());
+				ParsedCommand.Files.emplace_back(NextToken);
+			} while (Tokens.Next(NextToken));
 
-			for (int i = 0; i < ToOrder.size(); ++i) 
+			if (ParsedCommand.Files.size() > (ParsedCommand.CommandIndex == eDiff ? 2 : 1)) 
 			{
-				OrderedElements.at(i) = i;
+				ParsedCommand.CommandIndex = eInvalid;
 			}
 
-			std::sort(OrderedElements.begin(), OrderedElements.end(), MinToMax(ToOrder));
-
-			return OrderedElements;
-		} };
-
-		// Convert the command to lowercase to avoid any case issues
-		for (int i = 0; i < CurCmd.size(); i++) 
-		{
-			CurCmd.at(i) = std::tolower(CurCmd.at(i));
-		}
-
-		// Determine if the start of the command contains a valid main command by looping through our vector of valid commands
-		for (; ParsedCommand.CommandIndex < ValidCommands.size(); ParsedCommand.CommandIndex++) 
-		{
-			if (CurCmd.find(ValidCommands.at(ParsedCommand.CommandIndex)) == 0) {
-				bFound = true;
-				break;
-			}
+			return;
 		}
 
-		// The command is invalid
-		if (!bFound) 
+		if (!ParseQuery(Tokens, NextToken)) 
 		{
 			ParsedCommand.CommandIndex = eInvalid;
-
-			return;
+			ParsedCommand.SubCommandIndex.clear();
+			Filter.Clear();
 		}
+	}
 
-		// Determine if the command contains a "get" request by checking for the "get" keyword
-		if (CurCmd.find(L"get") != std::wstring::npos && CurCmd.size() != ValidCommands.at(ParsedCommand.CommandIndex).size() + 3) 
+	/// <summary>
+	///		Extract "--option" arguments from the command
+	/// </summary>
+	/// 
+	/// <param name="Unknown">First unknown option</param>
+	/// 
+	/// <returns>bool</returns>
+	bool ParseOptions(std::wstring& Unknown) 
+	{
+		Tokenizer Tokens { CurCmd };
+		std::wstring_view Token {};
+		std::wstring Command {};
+		size_t Kept {};
+
+		// Options apply to one command, e.g. one script line
+		OutputFormat = Serializer::eText;
+		bCompress = false;
+		TracePath.clear();
+		Unknown.clear();
+
+		// Options are split like the rest of the command, text between them is kept as is, e.g. quoted literals
+		while (Tokens.Next(Token)) 
 		{
-			// Determine if "get" is directly after the main command. If it's not, it's an invalid command
-			if (CurCmd.find(L"get") != ValidCommands.at(ParsedCommand.CommandIndex).size()) 
+			if (Token.size() < 2 || Token.substr(0, 2) != L"--") 
 			{
-				ParsedCommand.CommandIndex = eInvalid;
-
-				return;
+				continue;
 			}
 
-			// If sub command has two and more arguments
-			std::vector <std::wstring> SubCmds { ValidSubCommands() };
-			std::vector <int> UnorderedSubIndex {};
-			std::vector <int> Offsets {};
+			std::wstring Argument { Token };
+			size_t Begin { (size_t)(Token.data() - CurCmd.data()) };
+			size_t End { Begin + Token.size() };
 
-			for (int i = 0; i < SubCmds.size(); i++) 
+			for (auto& Symbol : Argument) 
 			{
-				auto Offset { CurCmd.find(SubCmds.at(i)) };
-
-				if (Offset != std::wstring::npos) 
-				{
-					UnorderedSubIndex.push_back(i);
-					Offsets.push_back(Offset);
-				}
+				Symbol = Tokenizer::ToLower(Symbol);
 			}
 
-			// No valid sub-commands, but "get" is present - invalid command
-			if (UnorderedSubIndex.size() == 0 || Offsets.size() == 0) 
+			if (Argument == L"--json") 
 			{
-				ParsedCommand.CommandIndex = eInvalid;
-
-				return;
+				OutputFormat = Serializer::eJSON;
 			}
-
-			// Check if it's valid command
-			auto OrderedOffsets { OrderVector(Offsets) };
-			if (Offsets.at(OrderedOffsets.at(0)) != ValidCommands.at(ParsedCommand.CommandIndex).size() + 3) 
+			else if (Argument == L"--ndjson") 
 			{
-				ParsedCommand.CommandIndex = eInvalid;
-				return;
+				OutputFormat = Serializer::eNDJSON;
+			}
+			else if (Argument == L"--csv") 
+			{
+				OutputFormat = Serializer::eCSV;
+			}
+			else if (Argument == L"--compress") 
+			{
+				bCompress = true;
 			}
+			else if (Argument == L"--trace" && Tokens.Next(Token)) 
+			{
+				// File name follows the option, recording starts by StartTrace once the command is valid
+				End = (size_t)(Token.data() - CurCmd.data()) + Token.size();
 
-			// Sort sub-command indices from closest to farthest relative to "get"
-			ParsedCommand.SubCommandIndex.resize(UnorderedSubIndex.size());
+				if (Token.size() > 1 && Token.front() == L'"' && Token.back() == L'"') 
+				{
+					Token = Token.substr(1, Token.size() - 2);
+				}
 
-			for (int i = 0; i < UnorderedSubIndex.size(); i++) 
+				TracePath = Token;
+			}
+			else if (Unknown.empty()) 
 			{
-				ParsedCommand.SubCommandIndex.at(i) = UnorderedSubIndex.at(OrderedOffsets.at(i));
+				Unknown = Argument;
 			}
+
+			Command.append(CurCmd, Kept, Begin - Kept);
+			Kept = End;
 		}
-		// Invalid command
-		else if (CurCmd.size() > ValidCommands.at(ParsedCommand.CommandIndex).size()) 
+
+		Command.append(CurCmd, Kept, std::wstring::npos);
+
+		// Nothing but separators is an empty command
+		if (!Tokenizer(Command).Next(Token)) 
 		{
-			ParsedCommand.CommandIndex = eInvalid;
+			Command.clear();
 		}
+
+		CurCmd = Command;
+
+		return Unknown.empty();
 	}
 
 	/// <summary>
-	///		Respond command
+	///		Serialize parsed command in the selected output format and append it to console output
 	/// </summary>
-	void RespondCommand() 
+	void SerializeCommand() 
 	{
-		ParseCommand();
+		Output.Begin(OutputFormat, ParsedCommand.CommandIndex == eAll ? eAll - eDisk : 1);
 
-		// Handle subcommands if present
-		if (ParsedCommand.SubCommandIndex.size()) 
+		if (ParsedCommand.CommandIndex == eAll) 
 		{
-			std::wcout << std::endl;
-
-			switch (ParsedCommand.CommandIndex) 
+			for (auto& Category : Fields::Categories) 
 			{
-			// Disk subcommand
-			case eDisk: 
-			{
-				for (int i = 0; i < ParsedCommand.SubCommandIndex.size(); i++) 
-				{
-					switch (ParsedCommand.SubCommandIndex.at(i)) 
-					{
-					case 1: 
-					{
-						for (int j = 0; j < HWID.Disk.size(); j++) 
-						{
-							FmtPrint(HWID.Disk.at(j).SerialNumber, eDisk, j);
-						}
-					} break;
+				SerializeCategory(Category, {});
+			}
+		}
+		else if (auto Category { ParsedCategory() }) 
+		{
+			SerializeCategory(*Category, ParsedCommand.SubCommandIndex);
+		}
 
-					case 2: 
-					{
-						for (int j = 0; j < HWID.Disk.size(); j++) 
-						{
-							FmtPrint(HWID.Disk.at(j).Model, eDisk, j);
-						}
-					} break;
+		Output.End();
 
-					case 3: 
-					{
-						for (int j = 0; j < HWID.Disk.size(); j++) 
-						{
-							FmtPrint(HWID.Disk.at(j).Interface, eDisk, j);
-						}
-					} break;
+		// Raw UTF-8 bytes
+		Console.Write(Output.GetBuffer());
+	}
 
-					case 4: 
-					{
-						for (int j = 0; j < HWID.Disk.size(); j++)
-						{
-							FmtPrint(HWID.Disk.at(j).DriveLetter, eDisk, j);
-						}
-					} break;
+	/// <summary>
+	///		Get categories required by the parsed command
+	/// </summary>
+	/// 
+	/// <returns>unsigned int</returns>
+	unsigned int RequiredCategories() 
+	{
+		if (auto Category { ParsedCategory() }) 
+		{
+			return Category->Query;
+		}
 
-					case 5: 
-					{
-						for (int j = 0; j < HWID.Disk.size(); j++)
-						{
-							FmtPrint(HWID.Disk.at(j).Size, eDisk, j);
-						}
-					} break;
+		if (ParsedCommand.CommandIndex == eAll || ParsedCommand.CommandIndex == eSave || ParsedCommand.CommandIndex == eServe 
+			|| ParsedCommand.CommandIndex == ePublish || ParsedCommand.CommandIndex == eListen) 
+		{
+			return ComputerStatistics::eQueryAll;
+		}
 
-					case 6: 
-					{
-						for (int j = 0; j < HWID.Disk.size(); j++) 
-						{
-							FmtPrint(HWID.Disk.at(j).FreeSpace, eDisk, j);
-						}
-					} break;
+		return ComputerStatistics::eQueryNone;
+	}
 
-					case 7: 
-					{
-						for (int j = 0; j < HWID.Disk.size(); j++) 
-						{
-							FmtPrint(HWID.Disk.at(j).MediaType, eDisk, j);
-						}
-					} break;
+	/// <summary>
+	///		Start recording if the parsed command has --trace, it's called before inventory collection, so collection is traced too.
+	///		Invalid command isn't traced, otherwise recording would stay enabled without a writer
+	/// </summary>
+	void StartTrace() 
+	{
+		if (ParsedCommand.CommandIndex == eInvalid) 
+		{
+			TracePath.clear();
+		}
 
-					case 8: 
-					{
-						for (int j = 0; j < HWID.Disk.size(); j++) 
-						{
-							FmtPrint(HWID.Disk.at(j).IsBootDrive, eDisk, j);
-						}
-					} break;
-					}
+		if (TracePath.size()) 
+		{
+			Trace::Start();
+		}
+	}
+
+	// Pipe clients commands are responded from the "listen" command
+	bool RespondCommand();
+
+	/// <summary>
+	///		Respond command received from pipe client, only inventory queries and save are available
+	/// </summary>
+	/// 
+	/// <param name="Request">UTF-8 command</param>
+	/// <param name="Response">Response payload</param>
+	/// 
+	/// <returns>bool</returns>
+	bool RespondRequest(const std::string& Request, std::string& Response) 
+	{
+		std::wstring Unknown {};
+		bool bSuccess {};
+
+		Requests++;
+		CurCmd.resize(MultiByteToWideChar(CP_UTF8, 0, Request.data(), (int)Request.size(), nullptr, 0));
+
+		if (CurCmd.size()) 
+		{
+			MultiByteToWideChar(CP_UTF8, 0, Request.data(), (int)Request.size(), &CurCmd[0], (int)CurCmd.size());
+		}
+
+		if (!ParseOptions(Unknown)) 
+		{
+			Console << L"\nError! Unknown option " << Unknown << L"...\n";
+		}
+		else if (TracePath.size() || bCompress) 
+		{
+			// Files are written by the host, a client mustn't choose them
+			Console << L"\nError! --trace and --compress aren't available for pipe clients...\n";
+
+			TracePath.clear();
+			bCompress = false;
+		}
+		else 
+		{
+			ParseCommand();
+
+			// Long-running and host-only commands would block other clients
+			if (ParsedCommand.CommandIndex > eAll && ParsedCommand.CommandIndex != eSave) 
+			{
+				Console << L"\nError! Command isn't available for pipe clients...\n";
+
+				ParsedCommand.CommandIndex = eInvalid;
+				ParsedCommand.SubCommandIndex.clear();
+				Filter.Clear();
+			}
+			else 
+			{
+				RefreshChanged();
+				bSuccess = RespondCommand();
+			}
+		}
+
+		Console.Take(Response);
+
+		return bSuccess;
+	}
+
+	/// <summary>
+	///		Respond parsed command
+	/// </summary>
+	/// 
+	/// <returns>bool</returns>
+	bool RespondCommand() 
+	{
+		bool bSuccess { true };
+
+		// Machine-readable output
+		if (OutputFormat != Serializer::eText && ParsedCommand.CommandIndex >= eDisk && ParsedCommand.CommandIndex <= eAll) 
+		{
+			SerializeCommand();
+
+			goto ClearCmd;
+		}
+
+		// Handle subcommands if present
+		if (ParsedCommand.SubCommandIndex.size()) 
+		{
+			Console << L"\n";
+			PrintFields(*ParsedCategory(), ParsedCommand.SubCommandIndex);
+
+			goto ClearCmd;
+		}
+
+		// Handle main command
+		switch (ParsedCommand.CommandIndex) 
+		{
+		// Music on
+		case eMusicOn: 
+		{
+			if (!PlaySound(MUSIC_FILE, NULL, SND_FILENAME | SND_LOOP | SND_ASYNC | SND_NODEFAULT)) 
+			{
+				Console.SetColor(FOREGROUND_RED);
+
+				Console << L"\nError! Music file not found...\n";
+				bSuccess = false;
+			}
+			else
+			{
+				Console << L"\nMusic on!\n";
+			}
+		} break;
+
+		// Music off
+		case eMusicOff: 
+		{
+			if (!PlaySound(NULL, NULL, SND_FILENAME)) 
+			{
+				Console.SetColor(FOREGROUND_RED);
+
+				Console << L"\nError! Can't stop music file...\n";
+				bSuccess = false;
+			}
+			else
+			{
+				Console << L"\nMusic off!\n";
+			}
+		} break;
+
+		// Categories information
+		case eDisk: 
+		case eSMBIOS: 
+		case eGPU: 
+		case eCPU: 
+		case eNetwork: 
+		case eSystem: 
+		case ePhysicalMemory: 
+		case eRegistry: 
+		{
+			Console << L"\n";
+			PrintCategory(*ParsedCategory());
+		} break;
+
+		// All information
+		case eAll: 
+		{
+			for (auto& Category : Fields::Categories) 
+			{
+				Console << L"\n--------------------------\n";
+				Console << Report::CategoryTitle(Category, L'|') << L"\n";
+				Console << L"--------------------------\n\n";
+				PrintCategory(Category);
+			}
+		} break;
+
+		// CPU and memory load
+		case eRealTime: 
+		{
+			std::wstring logPath { bCompress ? LOG_FILE COMPRESSED_EXTENSION : LOG_FILE };
+			LogStream logFile;
+			logFile.open(logPath, bCompress);
+
+			std::ofstream alertsFile;
+			std::vector <AlertEngine::Event> alertEvents {};
+
+			// Compile alert rules once
+			if (!Alerts.IsCompiled())
+			{
+				std::vector <std::wstring> Errors {};
+
+				Alerts.Compile(ALERTS_FILE, Errors);
+
+				for (auto& Error : Errors)
+				{
+					Console << L"\nInvalid alert rule, " << Error;
 				}
-			} break;
+			}
 
-			// SMBIOS subcommand
-			case eSMBIOS: 
+			if (!Alerts.IsEmpty())
 			{
-				for (int i = 0; i < ParsedCommand.SubCommandIndex.size(); i++) 
+				alertsFile.open(ALERTS_LOG_FILE, std::ios::out | std::ios::app);
+			}
+
+			SelfOverhead Overhead {};
+			std::string overheadText {};
+
+			// Interactive console shows the dashboard, redirected output gets lines as before
+			Dashboard Screen {};
+			bool bDashboard { Screen.Start(Console) };
+			auto IsStopPressed { []() { return ((GetKeyState(VK_CONTROL) & 0x80) & (GetKeyState(VK_Z) & 0x80)) != 0; } };
+
+			// While CTRL + Z isn't pressed
+			for (unsigned long long Samples = 0; !IsStopPressed(); Samples++)
+			{
+				// Get current time
+				auto timestamp = std::chrono::system_clock::now();
+				time_t time = std::chrono::system_clock::to_time_t(timestamp);
+
+				// Get CPU and memory load
+				float cpuLoad = HWID.GetCPULoad() * 100;
+				float memoryLoad = HWID.GetMemoryLoad();
+
+				// Console print
+				if (!bDashboard) 
 				{
-					switch (ParsedCommand.SubCommandIndex.at(i)) 
-					{
-					case 1: 
-					{
-						std::wcout << HWID.SMBIOS.SerialNumber << std::endl;
-					} break;
+					Console << L"\nCurrent time: " << std::ctime(&time) 
+						<< L"CPU load: " << cpuLoad << L"%, Memory load: " << memoryLoad << L"%\n";
+				}
 
-					case 2: 
-					{
-						std::wcout << HWID.SMBIOS.Manufacturer << std::endl;
-					} break;
+				// Own footprint of the previous sample, including its sleep and frames
+				if (Samples) 
+				{
+					SelfOverhead::Sample Measured { Overhead.Measure() };
+
+					overheadText = FormatOverhead(Measured, "sample");
 
-					case 3: 
+					if (bDashboard) 
 					{
-						std::wcout << HWID.SMBIOS.Product << std::endl;
-					} break;
+						Screen.SetStatus(std::wstring(overheadText.begin(), overheadText.end()), SelfOverhead::IsOverBudget(Measured));
+					}
+					else 
+					{
+						PrintOverhead(overheadText, Measured);
+					}
+				}
+				else 
+				{
+					Overhead.Begin();
+				}
+				
+				// File print
+				{
+					Trace::Span Span { "WriteLog", "io", logPath };
+
+					logFile << "\nSaved time: " << std::ctime(&time)
+						<< "CPU load: " << cpuLoad << "%, Memory load: " << memoryLoad << "%\n";
 
-					case 4: 
+					if (overheadText.size()) 
 					{
-						std::wcout << HWID.SMBIOS.Version << std::endl;
-					} break;
+						logFile << overheadText << "\n";
 					}
+
+					logFile.flush();
 				}
-			} break;
 
-			// GPU subcommand
-			case eGPU: 
-			{
-				for (int i = 0; i < ParsedCommand.SubCommandIndex.size(); i++) 
+				// Rotation happens between samples, the file is complete when it's renamed
+				if (Rotation.IsDue(logPath))
+				{
+					Trace::Span Span { "Rotate", "io", logPath };
+
+					logFile.close();
+					Rotation.Rotate(logPath);
+					logFile.open(logPath, bCompress);
+				}
+
+				// Evaluate alert rules
+				if (!Alerts.IsEmpty())
 				{
-					switch (ParsedCommand.SubCommandIndex.at(i)) 
+					Alerts.SetLoad(cpuLoad, memoryLoad);
+
+					for (int i = 0; i < Alerts.GetDrives().size(); i++)
 					{
-					case 1: 
+						Alerts.SetFreeSpace(i, HWID.GetFreeSpace(Alerts.GetDrives().at(i)));
+					}
+
+					Alerts.Evaluate(std::chrono::steady_clock::now(), alertEvents);
+
+					for (auto& Event : alertEvents)
 					{
-						for (int i = 0; i < HWID.GPU.size(); i++) 
+						// Dashboard keeps the latest event in place
+						if (bDashboard) 
 						{
-							FmtPrint(HWID.GPU.at(i).Name, eGPU, i);
+							Screen.SetEvent(Event);
 						}
-					} break;
-
-					case 2: 
-					{
-						for (int i = 0; i < HWID.GPU.size(); i++) 
+						else 
 						{
-							FmtPrint(HWID.GPU.at(i).DriverVersion, eGPU, i);
+							Console.SetColor(Event.IsStart ? FOREGROUND_RED : FOREGROUND_GREEN);
+
+							Console << (Event.IsStart ? L"Alert started: " : L"Alert ended: ") << *Event.Rule << L" (value: " << Event.Value << L")\n";
+
+							Console.SetColor(FOREGROUND_WHITE);
 						}
-					} break;
 
-					case 3: 
+						std::string Rule {};
+
+						Serializer::AppendUTF8(Rule, *Event.Rule);
+
+						alertsFile << "\nAlert time: " << std::ctime(&time)
+							<< (Event.IsStart ? "Alert started: " : "Alert ended: ") << Rule << " (value: " << Event.Value << ")\n";
+					}
+
+					alertsFile.flush();
+				}
+
+				Console.Flush();
+
+				if (!bDashboard) 
+				{
+					Sleep(1000);
+					continue;
+				}
+
+				// Frames are drawn between samples, only changed cells are written
+				Screen.SampleDevices(HWID);
+
+				for (int Frame = 0; Frame < 1000 / DASHBOARD_FRAME_INTERVAL && !IsStopPressed(); Frame++) 
+				{
+					Screen.Draw();
+					Console.Flush();
+
+					Sleep(DASHBOARD_FRAME_INTERVAL);
+				}
+			}
+
+			Screen.Stop();
+
+			logFile.close();
+			alertsFile.close();
+
+			Console << (bCompress ? L"\nLogs were saved in logs/log.csv.lz!\n" : L"\nLogs were saved in logs/logs.csv!\n");
+
+			if (bCompress) 
+			{
+				PrintCompression(logFile);
+			}
+		} break;
+
+		// Save all information
+		case eSave: 
+		{
+			std::wstring statisticsPath { bCompress ? STATISTICS_FILE COMPRESSED_EXTENSION : STATISTICS_FILE };
+
+			if (Rotation.IsDue(statisticsPath))
+			{
+				Rotation.Rotate(statisticsPath);
+			}
+
+			statisticsFile.open(statisticsPath, bCompress);
+
+			// Get current time
+			auto timestamp = std::chrono::system_clock::now();
+			time_t time = std::chrono::system_clock::to_time_t(timestamp);
+
+			// The whole dump is encoded into one reused buffer and written at once
+			{
+				Trace::Span Span { "FormatStatistics", "output" };
+
+				SaveText.assign("\nSaved time: ").append(std::ctime(&time));
+
+				for (auto& Category : Fields::Categories) 
+				{
+					SaveText.append("\n--------------------------\n");
+					Serializer::AppendUTF8(SaveText, Report::CategoryTitle(Category, L' '));
+					SaveText.append("\n--------------------------\n\n");
+					SaveCategory(Category);
+				}
+			}
+
+			{
+				Trace::Span Span { "WriteStatistics", "io", statisticsPath };
+
+				statisticsFile.write(SaveText.data(), SaveText.size());
+				statisticsFile.close();
+			}
+
+			bool bSaved {};
+
+			// Latest snapshot in binary form, it can be loaded back
+			{
+				Trace::Span Span { "WriteSnapshot", "io", SNAPSHOT_FILE };
+
+				bSaved = BinarySnapshot::Save(HWID, SNAPSHOT_FILE, (long long)time);
+			}
+
+			if (!bSaved) 
+			{
+				Console.SetColor(FOREGROUND_RED);
+
+				Console << L"\nError! Can't write logs/statistics.bin...\n";
+				bSuccess = false;
+				break;
+			}
+
+			Console << L"\nStatistics were saved in logs/statistics.csv" << (bCompress ? L".lz" : L"") << L" and logs/statistics.bin!\n";
+
+			if (bCompress) 
+			{
+				PrintCompression(statisticsFile);
+			}
+		} break;
+
+		// Metrics endpoint
+		case eServe: 
+		{
+			MetricsServer Server {};
+			SelfOverhead Overhead {};
+			SelfOverhead Report {};
+
+			// Inventory doesn't change, load is rendered periodically and scrapes only copy the last buffer
+			auto Render { [&Server, &Overhead]() {
+				SelfOverhead::Sample Measured { Overhead.Measure() };
+
+				Server.BeginSample();
+				Server.AddGauge("comstat_cpu_load_percent", "CPU load in percent.", HWID.GetCPULoad() * 100);
+				Server.AddGauge("comstat_memory_load_percent", "Memory load in percent.", HWID.GetMemoryLoad());
+
+				// Volatile inventory values, they aren't labels of the info metrics
+				float Physical {};
+				float Virtual {};
+				float PageFile {};
+
+				if (HWID.GetAvailableMemory(Physical, Virtual, PageFile)) 
+				{
+					Server.AddGauge("comstat_memory_available_megabytes", "Available physical memory in MB.", Physical);
+					Server.AddGauge("comstat_virtual_memory_available_megabytes", "Available virtual memory in MB.", Virtual);
+					Server.AddGauge("comstat_page_file_available_megabytes", "Available page file size in MB.", PageFile);
+				}
+
+				// Disks without a letter have no free space, their samples would share one series
+				for (auto& Disk : HWID.Disk) 
+				{
+					float FreeSpace { Disk.DriveLetter.empty() ? -1.0f : HWID.GetFreeSpace(Disk.DriveLetter) };
+
+					if (FreeSpace >= 0) 
 					{
-						for (int i = 0; i < HWID.GPU.size(); i++) 
-						{
-							std::wstring Res(std::to_wstring(HWID.GPU.at(i).XResolution));
-							Res.append(L"x").append(std::to_wstring(HWID.GPU.at(i).YResolution));
+						Server.AddGauge("comstat_disk_free_space_gigabytes", "Free disk space in GB.", FreeSpace, "driveletter", Disk.DriveLetter);
+					}
+				}
 
-							FmtPrint(Res, eGPU, i);
-						}
-					} break;
+				// Own footprint since the previous render
+				Server.AddGauge("comstat_self_cpu_percent", "ComStat CPU usage in percent of one core.", Measured.CPUPercent);
+				Server.AddGauge("comstat_self_resident_megabytes", "ComStat resident memory in MB.", Measured.ResidentMB);
+				Server.AddGauge("comstat_self_allocations_per_render", "ComStat heap allocations per render.", Measured.Allocations);
+				Server.AddGauge("comstat_self_io_operations_per_render", "ComStat I/O operations per render.", Measured.IOOperations);
+
+				Server.PublishSample();
+			} };
+
+			// Hot-plug of a device outside the inventory collects the same inventory again, it's compared by interned snapshots
+			StringPool <wchar_t> Pool {};
+			InternedSnapshot Served { HWID, Pool };
+
+			Overhead.Begin();
+			Server.SetInventory(HWID);
+			Render();
 
-					case 4: 
+			if (!Server.Start(ParsedCommand.Port)) 
+			{
+				Console.SetColor(FOREGROUND_RED);
+
+				Console << L"\nError! Can't listen on port " << (int)ParsedCommand.Port << L"...\n";
+				bSuccess = false;
+				break;
+			}
+
+			Console << L"\nMetrics are served on http://127.0.0.1:" << (int)ParsedCommand.Port << L"/metrics, press CTRL + Z to stop\n";
+			Console.Flush();
+
+			Report.Begin();
+
+			// While CTRL + Z isn't pressed
+			for (int Seconds = 1; !((GetKeyState(VK_CONTROL) & 0x80) & (GetKeyState(VK_Z) & 0x80)); Seconds++) 
+			{
+				Sleep(1000);
+
+				if (Seconds % METRICS_REFRESH_INTERVAL == 0) 
+				{
+					if (RefreshChanged()) 
 					{
-						for (int i = 0; i < HWID.GPU.size(); i++) 
+						InternedSnapshot Refreshed { HWID, Pool };
+
+						if (!Refreshed.IsSameInventory(Served)) 
 						{
-							FmtPrint(HWID.GPU.at(i).RefreshRate, eGPU, i);
+							Server.SetInventory(HWID);
+							Served = std::move(Refreshed);
 						}
-					} break;
 					}
+
+					Render();
+				}
+
+				if (Seconds % OVERHEAD_REPORT_INTERVAL == 0) 
+				{
+					SelfOverhead::Sample Measured { Report.Measure(OVERHEAD_REPORT_INTERVAL / METRICS_REFRESH_INTERVAL) };
+
+					PrintOverhead(FormatOverhead(Measured, "render"), Measured);
+					Console.Flush();
 				}
-			} break;
+			}
 
-			// CPU subcommand
-			case eCPU: 
+			Server.Stop();
+
+			Console << L"\nMetrics server was stopped!\n";
+		} break;
+
+		// Shared memory snapshot
+		case ePublish: 
+		{
+			SnapshotPublisher Publisher {};
+			SnapshotSample Sample {};
+
+			if (!Publisher.Open()) 
 			{
-				for (int i = 0; i < ParsedCommand.SubCommandIndex.size(); i++) 
+				Console.SetColor(FOREGROUND_RED);
+
+				Console << L"\nError! Can't create shared memory " << SNAPSHOT_NAME << L"...\n";
+				bSuccess = false;
+				break;
+			}
+
+			// Inventory document is rendered once and published with the first sample, it's rendered again after hardware changes
+			auto Render { [&Sample]() {
+				Output.Begin(Serializer::eJSON, eAll - eDisk);
+
+				for (auto& Category : Fields::Categories) 
 				{
-					switch (ParsedCommand.SubCommandIndex.at(i)) 
-					{
-					case 1: 
+					SerializeCategory(Category, {});
+				}
+
+				Output.End();
+
+				Sample.DriveCount = (unsigned int)std::min(HWID.Disk.size(), (size_t)SNAPSHOT_MAX_DRIVES);
+
+				for (unsigned int i = 0; i < Sample.DriveCount; i++) 
+				{
+					wcsncpy(Sample.Drives[i].DriveLetter, HWID.Disk.at(i).DriveLetter.c_str(), 3);
+				}
+			} };
+
+			// Inventory is rendered again only if the hot-plug changed it, snapshots are compared by interned values
+			StringPool <wchar_t> Pool {};
+			InternedSnapshot Published { HWID, Pool };
+
+			Render();
+
+			Console << L"\nSnapshot is published in shared memory " << SNAPSHOT_NAME << L", press CTRL + Z to stop\n";
+			Console.Flush();
+
+			SelfOverhead Report {};
+			Report.Begin();
+
+			// While CTRL + Z isn't pressed
+			for (unsigned int Samples = 0; !((GetKeyState(VK_CONTROL) & 0x80) & (GetKeyState(VK_Z) & 0x80)); Samples++) 
+			{
+				bool bInventory { !Samples };
+
+				if (RefreshChanged()) 
+				{
+					InternedSnapshot Refreshed { HWID, Pool };
+
+					if (!Refreshed.IsSameInventory(Published)) 
 					{
-						std::wcout << HWID.CPU.ProcessorId << std::endl;
-					} break;
+						Render();
+						Published = std::move(Refreshed);
+						bInventory = true;
+					}
+				}
+
+				if (Samples && Samples % OVERHEAD_REPORT_INTERVAL == 0) 
+				{
+					SelfOverhead::Sample Measured { Report.Measure(OVERHEAD_REPORT_INTERVAL) };
+
+					PrintOverhead(FormatOverhead(Measured, "sample"), Measured);
+					Console.Flush();
+				}
+
+				Sample.Timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+				Sample.CPULoad = HWID.GetCPULoad() * 100;
+				Sample.MemoryLoad = HWID.GetMemoryLoad();
+
+				for (unsigned int i = 0; i < Sample.DriveCount; i++) 
+				{
+					Sample.Drives[i].FreeSpace = HWID.GetFreeSpace(HWID.Disk.at(i).DriveLetter);
+				}
+
+				if (!Publisher.Publish(Sample, bInventory ? &Output.GetBuffer() : nullptr)) 
+				{
+					Console.SetColor(FOREGROUND_RED);
+					Console << L"\nError! Inventory of " << (long long)Output.GetBuffer().size() << L" bytes exceeds " << SNAPSHOT_INVENTORY_SIZE 
+						<< L" bytes of shared memory, only samples are published...\n";
+					Console.SetColor(FOREGROUND_WHITE);
+				}
+
+				Sleep(1000);
+			}
+
+			Publisher.Close();
+
+			Console << L"\nSnapshot publishing was stopped!\n";
+		} break;
+
+		// Named pipe query server
+		case eListen: 
+		{
+			PipeServer Server {};
+
+			if (!Server.Start(RespondRequest)) 
+			{
+				Console.SetColor(FOREGROUND_RED);
+
+				Console << L"\nError! Can't create pipe " << PIPE_NAME << L"...\n";
+				bSuccess = false;
+				break;
+			}
+
+			Console << L"\nQueries are served on " << PIPE_NAME << L", press CTRL + Z to stop\n";
+			Console.Flush();
+
+			SelfOverhead Report {};
+			auto ReportTime { std::chrono::steady_clock::now() };
+
+			Report.Begin();
+			Requests = 0;
+
+			// Client commands are executed on this thread against the collected inventory
+			Console.SetCapture(true);
+
+			// While CTRL + Z isn't pressed
+			while (!((GetKeyState(VK_CONTROL) & 0x80) & (GetKeyState(VK_Z) & 0x80))) 
+			{
+				Server.Poll(PIPE_POLL_INTERVAL);
+
+				if (std::chrono::steady_clock::now() - ReportTime >= std::chrono::seconds(OVERHEAD_REPORT_INTERVAL)) 
+				{
+					SelfOverhead::Sample Measured { Report.Measure(Requests) };
+
+					// Report goes to the host console, not to a client
+					Console.SetCapture(false);
+					PrintOverhead(FormatOverhead(Measured, "request"), Measured);
+					Console.Flush();
+					Console.SetCapture(true);
 
-					case 2: 
-					{
-						std::wcout << HWID.CPU.Manufacturer << std::endl;
-					} break;
+					ReportTime = std::chrono::steady_clock::now();
+					Requests = 0;
+				}
+			}
 
-					case 3: 
-					{
-						std::wcout << HWID.CPU.Name << std::endl;
-					} break;
+			Server.Stop();
 
-					case 4: 
-					{
-						std::wcout << HWID.CPU.Cores << std::endl;
-					} break;
+			Console.SetCapture(false);
 
-					case 5: 
-					{
-						std::wcout << HWID.CPU.Threads << std::endl;
-					} break;
-					}
-				}
-			} break;
+			Console << L"\nPipe server was stopped!\n";
+		} break;
 
-			// Network subcommand
-			case eNetwork: 
+		// Difference of saved statistics
+		case eDiff: 
+		{
+			static const std::wstring ChangesName { L"changes" };
+			static const std::wstring ChangeKinds[] { L"changed", L"added", L"removed" };
+			InventoryDiff Diff {};
+			InventoryDump Before {};
+			InventoryDump After {};
+			std::vector <InventoryDiff::Change> Changes {};
+
+			// One file holds both dumps unless two files are given
+			auto& Files { ParsedCommand.Files };
+			std::wstring BeforeFile { Files.empty() ? STATISTICS_FILE : Files.front() };
+			std::wstring AfterFile { Files.size() == 2 ? Files.back() : BeforeFile };
+
+			if (!Before.Load(BeforeFile, Files.size() == 2 ? 0 : 1) || !After.Load(AfterFile, 0)) 
 			{
-				for (int i = 0; i < ParsedCommand.SubCommandIndex.size(); i++) 
-				{
-					switch (ParsedCommand.SubCommandIndex.at(i)) 
-					{
-					case 1: 
-					{
-						for (int i = 0; i < HWID.NetworkAdapter.size(); i++)
-						{
-							FmtPrint(HWID.NetworkAdapter.at(i).Name, eNetwork, i);
-						}
-					} break;
+				Console.SetColor(FOREGROUND_RED);
 
-					case 2: 
-					{
-						for (int i = 0; i < HWID.NetworkAdapter.size(); i++) 
-						{
-							FmtPrint(HWID.NetworkAdapter.at(i).MAC, eNetwork, i);
-						}
-					} break;
-					}
-				}
-			} break;
+				Console << L"\nError! Two saved dumps are required, " << BeforeFile << (Files.size() == 2 ? L" or " + AfterFile : L"") << L" has less...\n";
+				bSuccess = false;
+				break;
+			}
 
-			// OS subcommand
-			case eSystem: 
+			Diff.Compare(Before, After, Changes);
+
+			if (OutputFormat != Serializer::eText) 
 			{
-				for (int i = 0; i < ParsedCommand.SubCommandIndex.size(); i++) 
+				Output.Begin(OutputFormat, 1);
+				Output.BeginCategory(ChangesName, true);
+
+				for (auto& Change : Changes) 
 				{
-					switch (ParsedCommand.SubCommandIndex.at(i)) 
-					{
-					case 1: 
-					{
-						std::wcout << HWID.System.Name << std::endl;
-					} break;
+					Output.BeginRecord();
+					Output.Field(L"category", Change.Category->Name);
+					Output.Field(L"key", FromUTF8(Change.Key));
+					Output.Field(L"field", Change.Field ? Change.Field->Name : L"");
+					Output.Field(L"before", FromUTF8(Change.Before));
+					Output.Field(L"after", FromUTF8(Change.After));
+					Output.Field(L"change", ChangeKinds[Change.Kind]);
+					Output.EndRecord();
+				}
 
-					case 2: 
-					{
-						std::wcout << HWID.System.IsHypervisorPresent << std::endl;
-					} break;
+				Output.EndCategory();
+				Output.End();
 
-					case 3: 
-					{
-						std::wcout << HWID.System.OSVersion << std::endl;
-					} break;
+				Console.Write(Output.GetBuffer());
+				break;
+			}
 
-					case 4: 
-					{
-						std::wcout << HWID.System.OSName << std::endl;
-					} break;
+			Console << L"\nChanges from " << FromUTF8(Before.GetTime()) << L" to " << FromUTF8(After.GetTime()) << L":\n\n";
 
-					case 5: 
-					{
-						std::wcout << HWID.System.OSArchitecture << std::endl;
-					} break;
+			for (auto& Change : Changes) 
+			{
+				Console << Change.Category->Title;
 
-					case 6: 
-					{
-						std::wcout << HWID.System.OSSerialNumber << std::endl;
-					} break;
-					}
+				if (Change.Category->IsList) 
+				{
+					Console << L" [" << FromUTF8(Change.Key) << L"]";
 				}
-			} break;
 
-			// Memory subcommand
-			case ePhysicalMemory: 
-			{
-				for (int i = 0; i < ParsedCommand.SubCommandIndex.size(); i++) 
+				if (Change.Kind == InventoryDiff::eChanged) 
 				{
-					switch (ParsedCommand.SubCommandIndex.at(i)) 
-					{
-					case 1: 
-					{
-						std::wcout << HWID.PhysicalMemory.PartNumber << std::endl;
-					} break;
-					case 2: 
-					{
-						std::wcout << HWID.PhysicalMemory.TotalSize << L" MB" << std::endl;
-					} break;
-					case 3: 
-					{
-						std::wcout << HWID.PhysicalMemory.AvailableSize << L" MB" << std::endl;
-					} break;
-					case 4:
-					{
-						std::wcout << HWID.PhysicalMemory.TotalVirtualSize << L" MB" << std::endl;
-					} break;
-					case 5:
-					{
-						std::wcout << HWID.PhysicalMemory.AvailableVirtualSize << L" MB" << std::endl;
-					} break;
-					case 6:
-					{
-						std::wcout << HWID.PhysicalMemory.TotalPageSize << L" MB" << std::endl;
-					} break;
-					case 7:
-					{
-						std::wcout << HWID.PhysicalMemory.AvailablePageSize << L" MB" << std::endl;
-					} break;
-					}
+					Console << L": " << Change.Field->Label << L": " << FromUTF8(Change.Before) << L" -> " << FromUTF8(Change.After) << L"\n";
 				}
-			} break;
-
-			// Registry subcommand
-			case eRegistry: 
-			{
-				for (int i = 0; i < ParsedCommand.SubCommandIndex.size(); i++) 
+				else 
 				{
-					switch (ParsedCommand.SubCommandIndex.at(i)) 
-					{
-					case 1: 
-					{
-						std::wcout << HWID.Registry.ComputerHardwareId << std::endl;
-					} break;
-					case 2:
-					{
-						std::wcout << HWID.Registry.ComputerManufacturer << std::endl;
-					} break;
-					case 3:
-					{
-						std::wcout << HWID.Registry.ComputerName << std::endl;
-					} break;
-					}
+					Console << L": " << ChangeKinds[Change.Kind] << L"\n";
 				}
-			} break;
 			}
 
-			goto ClearCmd;
-		}
-
-		// Handle main command
-		switch (ParsedCommand.CommandIndex) 
-		{
-		// Music on
-		case eMusicOn: 
-		{
-			if (!PlaySound(MUSIC_FILE, NULL, SND_FILENAME | SND_LOOP | SND_ASYNC | SND_NODEFAULT)) 
-			{
-				HANDLE handle = GetStdHandle(STD_OUTPUT_HANDLE);
-				SetConsoleTextAttribute(handle, FOREGROUND_RED);
-
-				std::wcout << L"\nError! Music file not found...\n";
-			}
-			else
+			if (Changes.empty()) 
 			{
-				std::wcout << L"\nMusic on!\n";
+				Console << L"No changes\n";
 			}
 		} break;
 
-		// Music off
-		case eMusicOff: 
+		// Fleet summary
+		case eAggregate: 
 		{
-			if (!PlaySound(NULL, NULL, SND_FILENAME)) 
-			{
-				HANDLE handle = GetStdHandle(STD_OUTPUT_HANDLE);
-				SetConsoleTextAttribute(handle, FOREGROUND_RED);
+			static const std::wstring CountsName { L"counts" };
+			static const std::wstring PercentilesName { L"percentiles" };
+			FleetAggregate Fleet {};
+			auto Start { std::chrono::steady_clock::now() };
 
-				std::wcout << L"\nError! Can't stop music file...\n";
-			}
-			else
+			if (ParsedCommand.Files.empty() || !Fleet.Run(ParsedCommand.Files.front())) 
 			{
-				std::wcout << "\nMusic off!\n";
+				Console.SetColor(FOREGROUND_RED);
+
+				Console << L"\nError! Directory with statistics files is required...\n";
+				bSuccess = false;
+				break;
 			}
-		} break;
 
-		// Disks information
-		case eDisk: 
-		{
-			std::wcout << std::endl;
-			PrintDisks();
-		} break;
+			auto Milliseconds { std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - Start).count() };
 
-		// SMBIOS information
-		case eSMBIOS: 
-		{
-			std::wcout << std::endl;
-			PrintSMBIOS();
-		} break;
+			auto FieldName { [](size_t CategoryIndex, size_t FieldIndex) {
+				auto& Category { Fields::Categories.at(CategoryIndex) };
 
-		// GPU information
-		case eGPU: 
-		{
-			std::wcout << std::endl;
-			PrintGPUs();
-		} break;
+				return Category.Name + L"." + Category.Fields.at(FieldIndex).Name;
+			} };
 
-		// CPU information
-		case eCPU: 
-		{
-			std::wcout << std::endl;
-			PrintCPU();
-		} break;
+			if (OutputFormat != Serializer::eText) 
+			{
+				Output.Begin(OutputFormat, 2);
+				Output.BeginCategory(CountsName, true);
 
-		// Network information
-		case eNetwork: 
-		{
-			std::wcout << std::endl;
-			PrintNetwork();
-		} break;
+				for (auto& Group : Fleet.GetGroups()) 
+				{
+					for (auto& Count : Group.Counts) 
+					{
+						Output.BeginRecord();
+						Output.Field(L"field", FieldName(Group.CategoryIndex, Group.FieldIndex));
+						Output.Field(L"value", FromUTF8(Count.first));
+						Output.Field(L"count", (long long)Count.second);
+						Output.EndRecord();
+					}
+				}
 
-		// OS information
-		case eSystem: 
-		{
-			std::wcout << std::endl;
-			PrintSystem();
-		} break;
+				Output.EndCategory();
+				Output.BeginCategory(PercentilesName, true);
 
-		// Memory information
-		case ePhysicalMemory: 
-		{
-			std::wcout << std::endl;
-			PrintPhysicalMemory();
-		} break;
+				for (auto& Distribution : Fleet.GetDistributions()) 
+				{
+					Output.BeginRecord();
+					Output.Field(L"field", FieldName(Distribution.CategoryIndex, Distribution.FieldIndex));
+					Output.Field(L"count", (long long)Distribution.Values.size());
+					Output.Field(L"p50", (float)Distribution.Percentile(50));
+					Output.Field(L"p90", (float)Distribution.Percentile(90));
+					Output.Field(L"p99", (float)Distribution.Percentile(99));
+					Output.Field(L"max", (float)Distribution.Percentile(100));
+					Output.EndRecord();
+				}
 
-		// Registry information
-		case eRegistry: 
-		{
-			std::wcout << std::endl;
-			PrintRegistry();
-		} break;
+				Output.EndCategory();
+				Output.End();
 
-		// All information
-		case eAll: 
-		{
-			std::wcout << L"\n--------------------------\n";
-			std::wcout << L"|          Disks         |\n";
-			std::wcout << L"--------------------------\n\n";
-			PrintDisks();
-
-			std::wcout << L"\n--------------------------\n";
-			std::wcout << L"|         SMBIOS         |\n";
-			std::wcout << L"--------------------------\n\n";
-			PrintSMBIOS();
-
-			std::wcout << L"\n--------------------------\n";
-			std::wcout << L"|          GPUs          |\n";
-			std::wcout << L"--------------------------\n\n";
-			PrintGPUs();
-
-			std::wcout << L"\n--------------------------\n";
-			std::wcout << L"|           CPU          |\n";
-			std::wcout << L"--------------------------\n\n";
-			PrintCPU();
-
-			std::wcout << L"\n--------------------------\n";
-			std::wcout << L"|         Network        |\n";
-			std::wcout << L"--------------------------\n\n";
-			PrintNetwork();
-
-			std::wcout << L"\n--------------------------\n";
-			std::wcout << L"|         System         |\n";
-			std::wcout << L"--------------------------\n\n";
-			PrintSystem();
-
-			std::wcout << L"\n--------------------------\n";
-			std::wcout << L"|          Memory        |\n";
-			std::wcout << L"--------------------------\n\n";
-			PrintPhysicalMemory();
-
-			std::wcout << L"\n--------------------------\n";
-			std::wcout << L"|        Registry        |\n";
-			std::wcout << L"--------------------------\n\n";
-			PrintRegistry();
-		} break;
+				Console.Write(Output.GetBuffer());
+				break;
+			}
 
-		// CPU and memory load
-		case eRealTime: 
-		{
-			std::ofstream logFile;
-			logFile.open(LOG_FILE, std::ios::out | std::ios::app);
+			Console << L"\nFleet summary of " << (long long)Fleet.GetSnapshots() << L" snapshots (" << (long long)Fleet.GetSkipped() 
+				<< L" files skipped, " << (long long)Milliseconds << L" ms)\n";
 
-			// While CTRL + Z isn't pressed
-			while (!((GetKeyState(VK_CONTROL) & 0x80) & (GetKeyState(VK_Z) & 0x80)))
+			for (auto& Group : Fleet.GetGroups()) 
 			{
-				// Get current time
-				auto timestamp = std::chrono::system_clock::now();
-				time_t time = std::chrono::system_clock::to_time_t(timestamp);
-
-				// Get CPU and memory load
-				float cpuLoad = HWID.GetCPULoad() * 100;
-				float memoryLoad = HWID.GetMemoryLoad();
+				auto& Category { Fields::Categories.at(Group.CategoryIndex) };
 
-				// Console print
-				std::wcout << L"\nCurrent time: " << std::ctime(&time) 
-					<< L"CPU load: " << cpuLoad << L"%, Memory load: " << memoryLoad << L"%\n";
-				
-				// File print
-				logFile << "\nSaved time: " << std::ctime(&time)
-					<< "CPU load: " << cpuLoad << "%, Memory load: " << memoryLoad << "%\n";
+				Console << L"\n" << Category.Title << L" " << Category.Fields.at(Group.FieldIndex).Label << L":\n";
 
-				Sleep(1000);
+				for (auto& Count : Group.Counts) 
+				{
+					Console << L"\t" << (long long)Count.second << L"\t" << FromUTF8(Count.first) << L"\n";
+				}
 			}
 
-			logFile.close();
+			Console << L"\n";
 
-			std::wcout << L"\nLogs were saved in logs/logs.csv!\n";
+			for (auto& Distribution : Fleet.GetDistributions()) 
+			{
+				auto& Category { Fields::Categories.at(Distribution.CategoryIndex) };
+				auto& Field { Category.Fields.at(Distribution.FieldIndex) };
+
+				Console << Category.Title << L" " << Field.Label << L": p50 " << Distribution.Percentile(50) << Field.Unit 
+					<< L", p90 " << Distribution.Percentile(90) << Field.Unit << L", p99 " << Distribution.Percentile(99) << Field.Unit 
+					<< L", max " << Distribution.Percentile(100) << Field.Unit << L"\n";
+			}
 		} break;
 
-		// Save all information
-		case eSave: 
+		// Replace inventory with binary snapshot
+		case eLoad: 
 		{
-			statisticsFile.open(STATISTICS_FILE, std::ios::out | std::ios::app);
-
-			// Get current time
-			auto timestamp = std::chrono::system_clock::now();
-			time_t time = std::chrono::system_clock::to_time_t(timestamp);
-
-			statisticsFile << "\nSaved time: " << std::ctime(&time);
+			BinarySnapshot Snapshot {};
+			std::wstring File { ParsedCommand.Files.empty() ? SNAPSHOT_FILE : ParsedCommand.Files.front() };
 
-			statisticsFile << "\n--------------------------\n";
-			statisticsFile << "           Disks          \n";
-			statisticsFile << "--------------------------\n\n";
-			SaveDisks();
+			bool bOpened {};
 
-			statisticsFile << "\n--------------------------\n";
-			statisticsFile << "          SMBIOS          \n";
-			statisticsFile << "--------------------------\n\n";
-			SaveSMBIOS();
-
-			statisticsFile << "\n--------------------------\n";
-			statisticsFile << "           GPUs           \n";
-			statisticsFile << "--------------------------\n\n";
-			SaveGPUs();
+			{
+				Trace::Span Span { "ReadSnapshot", "io", File };
 
-			statisticsFile << "\n--------------------------\n";
-			statisticsFile << "            CPU           \n";
-			statisticsFile << "--------------------------\n\n";
-			SaveCPU();
+				bOpened = Snapshot.Open(File);
+			}
 
-			statisticsFile << "\n--------------------------\n";
-			statisticsFile << "          Network         \n";
-			statisticsFile << "--------------------------\n\n";
-			SaveNetwork();
+			if (!bOpened) 
+			{
+				Console.SetColor(FOREGROUND_RED);
 
-			statisticsFile << "\n--------------------------\n";
-			statisticsFile << "          System          \n";
-			statisticsFile << "--------------------------\n\n";
-			SaveSystem();
+				Console << L"\nError! " << File << L" isn't a valid snapshot...\n";
+				bSuccess = false;
+				break;
+			}
 
-			statisticsFile << "\n--------------------------\n";
-			statisticsFile << "           Memory         \n";
-			statisticsFile << "--------------------------\n\n";
-			SavePhysicalMemory();
+			time_t time = (time_t)Snapshot.GetTimestamp();
 
-			statisticsFile << "\n--------------------------\n";
-			statisticsFile << "         Registry         \n";
-			statisticsFile << "--------------------------\n\n";
-			SaveRegistry();
+			// Loaded inventory isn't live anymore
+			Devices.Stop();
 
-			statisticsFile.close();
+			HWID = ComputerStatistics(ComputerStatistics::eQueryNone);
+			Snapshot.Load(HWID);
 
-			std::wcout << L"\nStatistics were saved in logs/statistics.csv!\n";
+			Console << L"\nSnapshot saved at " << std::ctime(&time) << L"was loaded from " << File << L"!\n";
 		} break;
 
 		// Get help page
@@ -1199,29 +1546,51 @@ namespace CommandLine
 		{
 			ShellExecute(NULL, L"open", HELP_FILE, NULL, NULL, SW_SHOW);
 
-			std::wcout << L"\nHelp page was opened!\n";
+			Console << L"\nHelp page was opened!\n";
 		} break;
 
 		// Exit
 		case eExit: 
 		{
+			Console.Flush();
 			exit(0);
 		} break;
 
 		// Invalid command
 		default: 
 		{
-			HANDLE handle = GetStdHandle(STD_OUTPUT_HANDLE);
-			SetConsoleTextAttribute(handle, FOREGROUND_RED);
+			Console.SetColor(FOREGROUND_RED);
 
-			std::wcout << L"\nError! Invalid command...\n";
+			Console << L"\nError! Invalid command...\n";
+			bSuccess = false;
 		} break;
 		}
 
 	// Clear command
 	ClearCmd:
 		ParsedCommand.CommandIndex = eInvalid;
-		ParsedCommand.SubCommandIndex.resize(0);
+		ParsedCommand.SubCommandIndex.clear();
+		Filter.Clear();
+
+		// Trace covers the command and the inventory collection before it
+		if (TracePath.size()) 
+		{
+			if (Trace::Write(TracePath)) 
+			{
+				Console << L"\nTrace was saved in " << TracePath << L"!\n";
+			}
+			else 
+			{
+				Console.SetColor(FOREGROUND_RED);
+
+				Console << L"\nError! Can't write " << TracePath << L"...\n";
+				bSuccess = false;
+			}
+
+			TracePath.clear();
+		}
+
+		return bSuccess;
 	}
 
 	/// <summary>
@@ -1229,45 +1598,50 @@ namespace CommandLine
 	/// </summary>
 	void Create() 
 	{
-		HANDLE handle = GetStdHandle(STD_OUTPUT_HANDLE);
-		SetConsoleTextAttribute(handle, FOREGROUND_GREEN);
+		Console.SetColor(FOREGROUND_GREEN);
 
-		std::wcout << AppName;
+		Console << AppName;
 
 		// Respond commands
 		auto NewLine{ []() -> void {
-			HANDLE handle = GetStdHandle(STD_OUTPUT_HANDLE);
-			SetConsoleTextAttribute(handle, FOREGROUND_GREEN);
+			Console.SetColor(FOREGROUND_GREEN);
 
-			std::wcout << CmdName;
+			Console << CmdName;
 
-			SetConsoleTextAttribute(handle, FOREGROUND_WHITE);
+			Console.SetColor(FOREGROUND_WHITE);
 
 			std::getline(std::wcin, CurCmd);
 
-			ComputerStatistics::RemoveWhitespaces(CurCmd);
+			// Options
+			std::wstring Unknown {};
+			if (!ParseOptions(Unknown)) 
+			{
+				Console.SetColor(FOREGROUND_RED);
+
+				Console << L"\nError! Unknown option " << Unknown << L"...\n\n";
+
+				return;
+			}
+
 			if (CurCmd.empty()) 
 			{ 
 				return; 
 			}
 
-			bool bFmt 
-			{
-				(CurCmd.find(L"diskget") != std::wstring::npos && HWID.Disk.size() > 1
-				|| CurCmd.find(L"gpuget") != std::wstring::npos && HWID.GPU.size() > 1
-				|| CurCmd.find(L"networkget") != std::wstring::npos && HWID.NetworkAdapter.size() > 1)
-			};
+			ParseCommand();
+			StartTrace();
+
+			// Hardware plugged in or removed since the previous command
+			RefreshChanged();
 
 			RespondCommand();
 
-			if (!bFmt) 
-			{
-				std::wcout << std::endl;
-			}
+			Console << L"\n";
 		} };
 		
-		// Get all information
-		HWID = ComputerStatistics();
+		// Get all information, changes after it are watched
+		Devices.Start();
+		CollectInventory(ComputerStatistics::eQueryAll);
 
 		// Enter a new command
 		for (;;) 
@@ -1275,4 +1649,181 @@ namespace CommandLine
 			NewLine();
 		}
 	}
+
+	/// <summary>
+	///		Check if commands are typed in console, not piped
+	/// </summary>
+	/// 
+	/// <returns>bool</returns>
+	bool IsInteractive() 
+	{
+		DWORD Mode {};
+
+		return GetConsoleMode(GetStdHandle(STD_INPUT_HANDLE), &Mode);
+	}
+
+	/// <summary>
+	///		Execute commands from script against one inventory snapshot, one command per line, "#" starts a comment
+	/// </summary>
+	/// 
+	/// <param name="Script">Commands stream</param>
+	/// 
+	/// <returns>int</returns>
+	int ExecuteScript(std::wistream& Script) 
+	{
+		std::vector <std::wstring> Commands {};
+		std::wstring Unknown {};
+		unsigned int Categories { ComputerStatistics::eQueryNone };
+		bool bSuccess { true };
+
+		// Collect categories required by all commands at once
+		for (std::wstring Line {}; std::getline(Script, Line);) 
+		{
+			size_t Start { Line.find_first_not_of(L" \t\r") };
+
+			if (Start == std::wstring::npos || Line.at(Start) == L'#') 
+			{
+				continue;
+			}
+
+			CurCmd = Line;
+
+			if (ParseOptions(Unknown)) 
+			{
+				ParseCommand();
+				StartTrace();
+				Categories |= RequiredCategories();
+			}
+
+			Commands.push_back(Line);
+		}
+
+		if (Categories != ComputerStatistics::eQueryNone) 
+		{
+			CollectInventory(Categories);
+		}
+
+		for (auto& Command : Commands) 
+		{
+			CurCmd = Command;
+
+			if (!ParseOptions(Unknown)) 
+			{
+				Console.SetColor(FOREGROUND_RED);
+				Console << L"\nError! Unknown option " << Unknown << L"...\n";
+				Console.SetColor(FOREGROUND_WHITE);
+
+				bSuccess = false;
+				continue;
+			}
+
+			ParseCommand();
+			StartTrace();
+
+			if (!RespondCommand()) 
+			{
+				Console.SetColor(FOREGROUND_WHITE);
+
+				bSuccess = false;
+			}
+
+			// Large output is written in parts
+			if (Console.GetSize() > SCRIPT_FLUSH_SIZE) 
+			{
+				Console.Flush();
+			}
+		}
+
+		Console.Flush();
+
+		return bSuccess ? 0 : 1;
+	}
+
+	/// <summary>
+	///		Execute one command from program arguments, e.g. "ComStat cpu get name cores",
+	///		script file ("ComStat --script commands.txt") or piped commands
+	/// </summary>
+	/// 
+	/// <param name="argc">Arguments count</param>
+	/// <param name="argv">Arguments</param>
+	/// 
+	/// <returns>int</returns>
+	int Execute(int argc, wchar_t* argv[]) 
+	{
+		std::wstring Unknown {};
+
+		// Piped commands
+		if (argc == 1) 
+		{
+			return ExecuteScript(std::wcin);
+		}
+
+		// Script file, "-" is stdin
+		if (std::wstring(argv[1]) == L"--script") 
+		{
+			if (argc != 3) 
+			{
+				Console.SetColor(FOREGROUND_RED);
+				Console << L"Error! Usage: ComStat --script [file]\n";
+				Console.SetColor(FOREGROUND_WHITE);
+
+				return 2;
+			}
+
+			if (std::wstring(argv[2]) == L"-") 
+			{
+				return ExecuteScript(std::wcin);
+			}
+
+			std::wifstream Script(argv[2]);
+
+			if (!Script.is_open()) 
+			{
+				Console.SetColor(FOREGROUND_RED);
+				Console << L"Error! Script file " << argv[2] << L" not found...\n";
+				Console.SetColor(FOREGROUND_WHITE);
+
+				return 1;
+			}
+
+			return ExecuteScript(Script);
+		}
+
+		for (int i = 1; i < argc; i++) 
+		{
+			CurCmd.append(argv[i]).append(L" ");
+		}
+
+		// Options
+		if (!ParseOptions(Unknown)) 
+		{
+			Console.SetColor(FOREGROUND_RED);
+			Console << L"Error! Unknown option " << Unknown << L"...\n";
+			Console.SetColor(FOREGROUND_WHITE);
+
+			return 2;
+		}
+
+		// Collect only categories required by the command
+		ParseCommand();
+		StartTrace();
+		unsigned int Categories { RequiredCategories() };
+
+		// Long-running commands keep the inventory current
+		if (ParsedCommand.CommandIndex == eServe || ParsedCommand.CommandIndex == ePublish || ParsedCommand.CommandIndex == eListen) 
+		{
+			Devices.Start();
+		}
+
+		if (Categories != ComputerStatistics::eQueryNone) 
+		{
+			CollectInventory(Categories);
+		}
+
+		bool bSuccess { RespondCommand() };
+
+		Console.SetColor(FOREGROUND_WHITE);
+
+		return bSuccess ? 0 : 1;
+	}
 };
@@ -0,0 +1,641 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#define COMPRESSION_MAGIC 0x425A4C43
+#define COMPRESSION_BLOCK_SIZE 65536
+#define COMPRESSION_BLOCK_AGE 60
+#define COMPRESSION_HASH_BITS 12
+#define COMPRESSED_EXTENSION L".lz"
+
+/// <summary>
+///		LZ77 block codec and block container, every block is decompressed independently.
+///		Block is 12-byte header (magic, raw size, stored size) and data, data is stored as is if it doesn't shrink.
+///		Block data is a sequence of tokens (literals length and match length nibbles), literals and 2-byte match offsets
+/// </summary>
+class BlockCompression
+{
+
+public:
+
+	/// <summary>
+	///		Block header
+	/// </summary>
+	struct Header
+	{
+		unsigned int Magic {};
+		unsigned int RawSize {};
+		unsigned int StoredSize {};
+	};
+
+	/// <summary>
+	///		Append compressed block with header
+	/// </summary>
+	/// 
+	/// <param name="Input">Raw data</param>
+	/// <param name="Output">Output buffer</param>
+	static void AppendBlock(std::string_view Input, std::string& Output)
+	{
+		size_t Start { Output.size() };
+		Header BlockHeader { COMPRESSION_MAGIC, (unsigned int)Input.size(), 0 };
+
+		Output.append(sizeof(Header), '\0');
+		Compress(Input, Output);
+
+		// Incompressible data is stored
+		if (Output.size() - Start - sizeof(Header) >= Input.size())
+		{
+			Output.resize(Start + sizeof(Header));
+			Output.append(Input);
+		}
+
+		BlockHeader.StoredSize = (unsigned int)(Output.size() - Start - sizeof(Header));
+		memcpy(&Output.at(Start), &BlockHeader, sizeof(Header));
+	}
+
+	/// <summary>
+	///		Check if data starts with compressed block
+	/// </summary>
+	/// 
+	/// <param name="Data">Data</param>
+	/// 
+	/// <returns>bool</returns>
+	static bool IsCompressed(std::string_view Data)
+	{
+		unsigned int Magic {};
+
+		if (Data.size() < sizeof(Header))
+		{
+			return false;
+		}
+
+		memcpy(&Magic, Data.data(), sizeof(Magic));
+
+		return Magic == COMPRESSION_MAGIC;
+	}
+
+	/// <summary>
+	///		Decompress all blocks
+	/// </summary>
+	/// 
+	/// <param name="Data">Blocks</param>
+	/// <param name="Output">Raw data</param>
+	/// 
+	/// <returns>bool, false if a block is damaged, complete blocks before it are kept</returns>
+	static bool DecompressBlocks(std::string_view Data, std::string& Output)
+	{
+		Header BlockHeader {};
+
+		while (!Data.empty())
+		{
+			if (Data.size() < sizeof(Header))
+			{
+				return false;
+			}
+
+			memcpy(&BlockHeader, Data.data(), sizeof(Header));
+			Data.remove_prefix(sizeof(Header));
+
+			if (BlockHeader.Magic != COMPRESSION_MAGIC || BlockHeader.StoredSize > Data.size() || BlockHeader.StoredSize > BlockHeader.RawSize)
+			{
+				return false;
+			}
+
+			if (BlockHeader.StoredSize == BlockHeader.RawSize)
+			{
+				Output.append(Data.substr(0, BlockHeader.StoredSize));
+			}
+			else if (!Decompress(Data.substr(0, BlockHeader.StoredSize), BlockHeader.RawSize, Output))
+			{
+				return false;
+			}
+
+			Data.remove_prefix(BlockHeader.StoredSize);
+		}
+
+		return true;
+	}
+
+	/// <summary>
+	///		Compress data, output isn't limited, so the caller stores data if it doesn't shrink
+	/// </summary>
+	/// 
+	/// <param name="Input">Raw data</param>
+	/// <param name="Output">Output buffer</param>
+	static void Compress(std::string_view Input, std::string& Output)
+	{
+		const unsigned char* Data { (const unsigned char*)Input.data() };
+		unsigned int Table[1 << COMPRESSION_HASH_BITS] {};
+		size_t Anchor {};
+
+		// Last bytes are always literals, so match search never reads past the end
+		for (size_t i = 1; Input.size() >= 12 && i + 12 <= Input.size();)
+		{
+			unsigned int Sequence { Read32(Data + i) };
+			unsigned int& Entry { Table[(Sequence * 2654435761U) >> (32 - COMPRESSION_HASH_BITS)] };
+			size_t Candidate { Entry };
+
+			Entry = (unsigned int)i;
+
+			if (i - Candidate > 0xFFFF || Read32(Data + Candidate) != Sequence)
+			{
+				i++;
+				continue;
+			}
+
+			size_t Length { 4 };
+
+			while (i + Length + 5 < Input.size() && Data[Candidate + Length] == Data[i + Length])
+			{
+				Length++;
+			}
+
+			AppendSequence(Input.substr(Anchor, i - Anchor), i - Candidate, Length, Output);
+
+			i += Length;
+			Anchor = i;
+		}
+
+		AppendSequence(Input.substr(Anchor), 0, 0, Output);
+	}
+
+	/// <summary>
+	///		Decompress one block data
+	/// </summary>
+	/// 
+	/// <param name="Input">Compressed data</param>
+	/// <param name="RawSize">Raw data size</param>
+	/// <param name="Output">Output buffer</param>
+	/// 
+	/// <returns>bool</returns>
+	static bool Decompress(std::string_view Input, size_t RawSize, std::string& Output)
+	{
+		const unsigned char* Data { (const unsigned char*)Input.data() };
+		size_t Start { Output.size() };
+		size_t i {};
+
+		Output.reserve(Start + RawSize);
+
+		while (i < Input.size())
+		{
+			unsigned char Token { Data[i++] };
+			size_t Literals { (size_t)(Token >> 4) };
+
+			if (!ReadLength(Input, i, Literals) || Literals > Input.size() - i)
+			{
+				return false;
+			}
+
+			Output.append(Input.substr(i, Literals));
+			i += Literals;
+
+			// The last sequence has no match
+			if (i == Input.size())
+			{
+				break;
+			}
+
+			if (Input.size() - i < 2)
+			{
+				return false;
+			}
+
+			size_t Offset { Data[i] | (size_t)Data[i + 1] << 8 };
+			size_t Length { Token & 15u };
+
+			i += 2;
+
+			if (!ReadLength(Input, i, Length))
+			{
+				return false;
+			}
+
+			Length += 4;
+
+			if (!Offset || Offset > Output.size() - Start || Output.size() - Start + Length > RawSize)
+			{
+				return false;
+			}
+
+			// Match can overlap the bytes it produces
+			for (size_t j = 0; j < Length; j++)
+			{
+				Output.push_back(Output[Output.size() - Offset]);
+			}
+		}
+
+		return Output.size() - Start == RawSize;
+	}
+
+private:
+
+	/// <summary>
+	///		Read 4 bytes
+	/// </summary>
+	/// 
+	/// <param name="Data">Data</param>
+	/// 
+	/// <returns>unsigned int</returns>
+	static unsigned int Read32(const unsigned char* Data)
+	{
+		unsigned int Value {};
+
+		memcpy(&Value, Data, sizeof(Value));
+
+		return Value;
+	}
+
+	/// <summary>
+	///		Append literals and match
+	/// </summary>
+	/// 
+	/// <param name="Literals">Literals</param>
+	/// <param name="Offset">Match offset</param>
+	/// <param name="Length">Match length, 0 for the last sequence</param>
+	/// <param name="Output">Output buffer</param>
+	static void AppendSequence(std::string_view Literals, size_t Offset, size_t Length, std::string& Output)
+	{
+		size_t MatchLength { Length ? Length - 4 : 0 };
+
+		Output.push_back((char)((std::min <size_t>(Literals.size(), 15) << 4) | std::min <size_t>(MatchLength, 15)));
+		AppendLength(Literals.size(), Output);
+		Output.append(Literals);
+
+		if (!Length)
+		{
+			return;
+		}
+
+		Output.push_back((char)(Offset & 0xFF));
+		Output.push_back((char)(Offset >> 8));
+		AppendLength(MatchLength, Output);
+	}
+
+	/// <summary>
+	///		Append length continuation bytes, nibble 15 is followed by 255-valued bytes and the rest
+	/// </summary>
+	/// 
+	/// <param name="Length">Length</param>
+	/// <param name="Output">Output buffer</param>
+	static void AppendLength(size_t Length, std::string& Output)
+	{
+		if (Length < 15)
+		{
+			return;
+		}
+
+		for (Length -= 15; Length >= 255; Length -= 255)
+		{
+			Output.push_back((char)255);
+		}
+
+		Output.push_back((char)Length);
+	}
+
+	/// <summary>
+	///		Read length continuation bytes
+	/// </summary>
+	/// 
+	/// <param name="Input">Compressed data</param>
+	/// <param name="Position">Read position</param>
+	/// <param name="Length">Nibble value, full length after the call</param>
+	/// 
+	/// <returns>bool</returns>
+	static bool ReadLength(std::string_view Input, size_t& Position, size_t& Length)
+	{
+		if ((Length & 15) != 15)
+		{
+			return true;
+		}
+
+		for (unsigned char Byte = 255; Byte == 255; Length += Byte)
+		{
+			if (Position == Input.size())
+			{
+				return false;
+			}
+
+			Byte = (unsigned char)Input[Position++];
+		}
+
+		return true;
+	}
+};
+
+/// <summary>
+///		Stream buffer collecting blocks, full blocks are compressed and appended to file by background thread
+/// </summary>
+class CompressedBuffer : public std::streambuf
+{
+
+public:
+
+	/// <summary>
+	///		Destructor
+	/// </summary>
+	~CompressedBuffer()
+	{
+		close();
+	}
+
+	/// <summary>
+	///		Open file for appending blocks and start compression thread
+	/// </summary>
+	/// 
+	/// <param name="Path">File</param>
+	/// 
+	/// <returns>bool</returns>
+	bool open(const std::wstring& Path)
+	{
+		close();
+
+		Sink.open(std::filesystem::path(Path), std::ios::out | std::ios::app | std::ios::binary);
+
+		if (!Sink.is_open())
+		{
+			return false;
+		}
+
+		RawBytes = StoredBytes = 0;
+		CompressionTime = {};
+		bStop = false;
+		BlockStart = std::chrono::steady_clock::now();
+		Worker = std::thread(&CompressedBuffer::Compress, this);
+
+		return true;
+	}
+
+	/// <summary>
+	///		Write the last block and wait until all blocks are written
+	/// </summary>
+	void close()
+	{
+		if (!Worker.joinable())
+		{
+			return;
+		}
+
+		Submit();
+
+		{
+			std::lock_guard <std::mutex> Lock(Mutex);
+			bStop = true;
+		}
+
+		Ready.notify_one();
+		Worker.join();
+		Sink.close();
+	}
+
+	/// <summary>
+	///		Get compression statistics, complete after close
+	/// </summary>
+	/// 
+	/// <param name="Raw">Raw bytes</param>
+	/// <param name="Stored">Written bytes</param>
+	/// <param name="Seconds">Compression time</param>
+	void GetStatistics(unsigned long long& Raw, unsigned long long& Stored, double& Seconds)
+	{
+		std::lock_guard <std::mutex> Lock(Mutex);
+
+		Raw = RawBytes;
+		Stored = StoredBytes;
+		Seconds = CompressionTime.count();
+	}
+
+protected:
+
+	/// <summary>
+	///		Append symbol
+	/// </summary>
+	/// 
+	/// <param name="Symbol">Symbol</param>
+	/// 
+	/// <returns>int_type</returns>
+	int_type overflow(int_type Symbol) override
+	{
+		if (!traits_type::eq_int_type(Symbol, traits_type::eof()))
+		{
+			Block.push_back(traits_type::to_char_type(Symbol));
+			SubmitFull();
+		}
+
+		return traits_type::not_eof(Symbol);
+	}
+
+	/// <summary>
+	///		Append symbols
+	/// </summary>
+	/// 
+	/// <param name="Symbols">Symbols</param>
+	/// <param name="Count">Symbols count</param>
+	/// 
+	/// <returns>std::streamsize</returns>
+	std::streamsize xsputn(const char* Symbols, std::streamsize Count) override
+	{
+		Block.append(Symbols, (size_t)Count);
+		SubmitFull();
+
+		return Count;
+	}
+
+	/// <summary>
+	///		Flushing seals only an old block, so frequent flushes don't produce tiny blocks
+	/// </summary>
+	/// 
+	/// <returns>int</returns>
+	int sync() override
+	{
+		if (std::chrono::steady_clock::now() - BlockStart >= std::chrono::seconds(COMPRESSION_BLOCK_AGE))
+		{
+			Submit();
+		}
+
+		return 0;
+	}
+
+private:
+
+	/// <summary>
+	///		Pass full blocks to compression thread
+	/// </summary>
+	void SubmitFull()
+	{
+		if (Block.size() >= COMPRESSION_BLOCK_SIZE)
+		{
+			Submit();
+		}
+	}
+
+	/// <summary>
+	///		Pass current block to compression thread
+	/// </summary>
+	void Submit()
+	{
+		if (Block.empty())
+		{
+			return;
+		}
+
+		{
+			std::lock_guard <std::mutex> Lock(Mutex);
+			Blocks.push_back(std::move(Block));
+		}
+
+		Ready.notify_one();
+
+		Block.clear();
+		Block.reserve(COMPRESSION_BLOCK_SIZE);
+		BlockStart = std::chrono::steady_clock::now();
+	}
+
+	/// <summary>
+	///		Compression thread, blocks are written in submission order
+	/// </summary>
+	void Compress()
+	{
+		std::string Output {};
+		std::unique_lock <std::mutex> Lock(Mutex);
+
+		for (;;)
+		{
+			Ready.wait(Lock, [this]() { return bStop || !Blocks.empty(); });
+
+			if (Blocks.empty())
+			{
+				return;
+			}
+
+			std::string Raw { std::move(Blocks.front()) };
+			Blocks.pop_front();
+			Lock.unlock();
+
+			auto Start { std::chrono::steady_clock::now() };
+
+			Output.clear();
+			BlockCompression::AppendBlock(Raw, Output);
+
+			auto Elapsed { std::chrono::steady_clock::now() - Start };
+
+			Sink.write(Output.data(), Output.size());
+			Sink.flush();
+
+			Lock.lock();
+			RawBytes += Raw.size();
+			StoredBytes += Output.size();
+			CompressionTime += Elapsed;
+		}
+	}
+
+	std::string Block {};
+	std::deque <std::string> Blocks {};
+	std::ofstream Sink {};
+	std::thread Worker {};
+	std::mutex Mutex {};
+	std::condition_variable Ready {};
+	std::chrono::steady_clock::time_point BlockStart {};
+	std::chrono::duration <double> CompressionTime {};
+	unsigned long long RawBytes {};
+	unsigned long long StoredBytes {};
+	bool bStop {};
+};
+
+/// <summary>
+///		Log file output, plain text or compressed blocks
+/// </summary>
+class LogStream : public std::ostream
+{
+
+public:
+
+	/// <summary>
+	///		Constructor
+	/// </summary>
+	LogStream() : std::ostream(nullptr) {}
+
+	/// <summary>
+	///		Destructor
+	/// </summary>
+	~LogStream()
+	{
+		close();
+	}
+
+	/// <summary>
+	///		Open file for appending
+	/// </summary>
+	/// 
+	/// <param name="Path">File</param>
+	/// <param name="IsCompressed">Write compressed blocks</param>
+	void open(const std::wstring& Path, bool IsCompressed)
+	{
+		close();
+
+		bCompressed = IsCompressed;
+
+		if (bCompressed ? Compressed.open(Path) : Plain.open(std::filesystem::path(Path), std::ios::out | std::ios::app) != nullptr)
+		{
+			rdbuf(bCompressed ? (std::streambuf*)&Compressed : &Plain);
+			clear();
+		}
+		else
+		{
+			rdbuf(nullptr);
+		}
+	}
+
+	/// <summary>
+	///		Write buffered data and close file
+	/// </summary>
+	void close()
+	{
+		if (!rdbuf())
+		{
+			return;
+		}
+
+		flush();
+		bCompressed ? Compressed.close() : (void)Plain.close();
+		rdbuf(nullptr);
+	}
+
+	/// <summary>
+	///		Check if file is open
+	/// </summary>
+	/// 
+	/// <returns>bool</returns>
+	bool is_open() const
+	{
+		return rdbuf() != nullptr;
+	}
+
+	/// <summary>
+	///		Get compression statistics of the last compressed file, complete after close
+	/// </summary>
+	/// 
+	/// <param name="Raw">Raw bytes</param>
+	/// <param name="Stored">Written bytes</param>
+	/// <param name="Seconds">Compression time</param>
+	void GetStatistics(unsigned long long& Raw, unsigned long long& Stored, double& Seconds)
+	{
+		Compressed.GetStatistics(Raw, Stored, Seconds);
+	}
+
+private:
+
+	std::filebuf Plain {};
+	CompressedBuffer Compressed {};
+	bool bCompressed {};
+};
@@ -1,15 +1,34 @@
 #pragma once
-#pragma comment(lib, "wbemuuid.lib")
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cwchar>
+#include <cwctype>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <vector>
 #include <string>
+
+// Inventory types are portable, collection is Windows-only
+#ifdef _WIN32
+#pragma comment(lib, "wbemuuid.lib")
+
 #include <Windows.h>
 #include <comdef.h>
 #include <Wbemidl.h>
 #include <ntddscsi.h>
+#endif
+
+#include "../Api/async.h"
+#include "../Api/trace.h"
 
 #define MB 1048576
+#define WMI_QUERY_TIMEOUT 5000
+#define WMI_POLL_INTERVAL 10
+#define COLLECTION_TIMEOUT 20000
 
 /// <summary>
 ///		Computer statistics class
@@ -19,6 +38,23 @@ class ComputerStatistics
 
 public:
 
+	/// <summary>
+	///		Categories flags
+	/// </summary>
+	enum : unsigned int
+	{
+		eQueryNone = 0,
+		eQueryDisk = 1 << 0,
+		eQuerySMBIOS = 1 << 1,
+		eQueryCPU = 1 << 2,
+		eQueryGPU = 1 << 3,
+		eQuerySystem = 1 << 4,
+		eQueryNetwork = 1 << 5,
+		eQueryPhysicalMemory = 1 << 6,
+		eQueryRegistry = 1 << 7,
+		eQueryAll = 0xFF
+	};
+
 	/// <summary>
 	///		Return wstring if input is null
 	/// </summary>
@@ -41,6 +77,94 @@ public:
 		String.erase(std::remove(String.begin(), String.end(), L' '), String.end());
 	}
 
+	/// <summary>
+	///		Pad query results to the number of records with default values, e.g. after the query timed out
+	/// </summary>
+	/// 
+	/// <typeparam name="T">Type</typeparam>
+	/// <param name="Value">Values</param>
+	/// <param name="Count">Number of records</param>
+	template <typename T>
+	static void Pad(std::vector <T>& Value, size_t Count)
+	{
+		if (Value.size() < Count)
+		{
+			Value.resize(Count);
+		}
+	}
+
+	/// <summary>
+	///		Cancel running collection, remaining queries return at once with partial results, e.g. on CTRL + C
+	/// </summary>
+	static void Cancel()
+	{
+		bCancelled.store(true, std::memory_order_relaxed);
+	}
+
+	/// <summary>
+	///		Check if category wasn't collected completely, because its query timed out or collection was cancelled
+	/// </summary>
+	/// 
+	/// <param name="Category">Category flag</param>
+	/// 
+	/// <returns>bool</returns>
+	bool IsStale(unsigned int Category) const
+	{
+		return Stale & Category;
+	}
+
+	/// <summary>
+	///		Get disk number from the end of disk name, e.g. "\\.\PHYSICALDRIVE1"
+	/// </summary>
+	/// 
+	/// <param name="Name">Disk name</param>
+	/// 
+	/// <returns>int, -1 if the name doesn't end with a number</returns>
+	static int DiskNumber(const wchar_t* Name)
+	{
+		if (!Name)
+		{
+			return -1;
+		}
+
+		const wchar_t* End { Name + wcslen(Name) };
+		const wchar_t* Digits { End };
+
+		while (Digits > Name && iswdigit(Digits[-1]))
+		{
+			Digits--;
+		}
+
+		return Digits == End ? -1 : (int)wcstol(Digits, nullptr, 10);
+	}
+
+	/// <summary>
+	///		Match volumes to disks, every disk gets the first volume lying on it
+	/// </summary>
+	/// 
+	/// <param name="DiskName">Disks names</param>
+	/// <param name="VolumeDisk">Disk number of every volume, -1 if it's unknown</param>
+	/// <param name="DeviceId">Volumes names</param>
+	/// <param name="SortedDeviceId">Volume name of every disk, unmatched disks keep their value</param>
+	static void MatchVolumes(const std::vector <const wchar_t*>& DiskName, const std::vector <int>& VolumeDisk, const std::vector <const wchar_t*>& DeviceId, std::vector <const wchar_t*>& SortedDeviceId)
+	{
+		for (size_t i = 0; i < SortedDeviceId.size() && i < DiskName.size(); i++)
+		{
+			int Number { DiskNumber(DiskName.at(i)) };
+
+			for (size_t j = 0; j < VolumeDisk.size() && j < DeviceId.size(); j++)
+			{
+				if (Number >= 0 && VolumeDisk.at(j) == Number)
+				{
+					SortedDeviceId.at(i) = DeviceId.at(j);
+					break;
+				}
+			}
+		}
+	}
+
+#ifdef _WIN32
+
 	/// <summary>
 	///		Get cpu load in %
 	/// </summary>
@@ -67,6 +191,47 @@ public:
 		return memStat.dwMemoryLoad;
 	}
 
+	/// <summary>
+	///		Get available memory in MB, inventory keeps values of the last collection
+	/// </summary>
+	/// 
+	/// <param name="Physical">Available physical memory</param>
+	/// <param name="Virtual">Available virtual memory</param>
+	/// <param name="PageFile">Available page file size</param>
+	/// 
+	/// <returns>bool</returns>
+	bool GetAvailableMemory(float& Physical, float& Virtual, float& PageFile)
+	{
+		MEMORYSTATUSEX memStat;
+		memStat.dwLength = sizeof(memStat);
+
+		if (!GlobalMemoryStatusEx(&memStat))
+		{
+			return false;
+		}
+
+		Physical = (float)(memStat.ullAvailPhys / MB);
+		Virtual = (float)(memStat.ullAvailVirtual / MB);
+		PageFile = (float)(memStat.ullAvailPageFile / MB);
+
+		return true;
+	}
+
+	/// <summary>
+	///		Get free space of the drive in GB
+	/// </summary>
+	/// 
+	/// <param name="DriveLetter">Drive letter, e.g. "C:"</param>
+	/// 
+	/// <returns>float</returns>
+	float GetFreeSpace(const std::wstring& DriveLetter)
+	{
+		Trace::Span Span { "GetDiskFreeSpaceEx", "io", DriveLetter };
+		ULARGE_INTEGER FreeBytesAvailable {};
+
+		return GetDiskFreeSpaceEx((DriveLetter + L"\\").c_str(), &FreeBytesAvailable, nullptr, nullptr) ? FreeBytesAvailable.QuadPart / pow(1024, 3) : -1.0f;
+	}
+
 private:
 
 	/// <summary>
@@ -115,6 +280,7 @@ private:
 	/// <returns>std::wstring</returns>
 	std::wstring GetHKLM(std::wstring SubKey, std::wstring Value) 
 	{
+		Trace::Span Span { "RegGetValue", "registry", Value };
 		DWORD Size {};
 		std::wstring Ret {};
 
@@ -146,39 +312,51 @@ private:
 	}
 
 	/// <summary>
-	///		General query execute
+	///		WMI namespace connection of the collection, it's shared with the connecting worker, so an abandoned connection
+	///		is released by the worker when it eventually returns. Services and pending flag belong to the loop thread
+	/// </summary>
+	struct WMIConnection
+	{
+		IWbemServices* Connected {};
+		HRESULT hResult { E_FAIL };
+		IWbemServices* Services {};
+		std::wstring ServerName {};
+		std::atomic <bool> bClaimed {};
+		bool bPending { true };
+	};
+
+	/// <summary>
+	///		Connect to the WMI namespace once per collection, queries share the connection
 	/// </summary>
 	/// 
-	/// <typeparam name="T">Type</typeparam>
-	/// <param name="WMIClass">Class name</param>
-	/// <param name="Field">Filed name</param>
-	/// <param name="Value">Value</param>
 	/// <param name="ServerName">Server name</param>
-	template <typename T = const wchar_t*>
-	void QueryWMI(std::wstring WMIClass, std::wstring Field, std::vector <T>& Value, const wchar_t* ServerName = L"ROOT\\CIMV2") 
+	/// 
+	/// <returns>Async::Task <IWbemServices*>, nullptr if the connection failed or timed out, the collection releases it</returns>
+	Async::Task <IWbemServices*> ConnectWMI(const wchar_t* ServerName) 
 	{
-		// Build query
-		std::wstring Query(L"SELECT ");
-		Query.append(Field.c_str()).append(L" FROM ").append(WMIClass.c_str());
+		auto Found { std::find_if(Connections.begin(), Connections.end(), [ServerName](const std::shared_ptr <WMIConnection>& Connection) {
+			return Connection->ServerName == ServerName;
+		}) };
 
-		// Initialization
-		IWbemLocator* Locator {};
-		IWbemServices* Services {};
-		IEnumWbemClassObject* Enumerator {};
-		IWbemClassObject* ClassObject {};
-		VARIANT Variant {};
-		DWORD Returned {};
+		// Queries started while the namespace is connecting wait for that connection
+		if (Found != Connections.end())
+		{
+			auto Connection { *Found };
 
-		// Initialize COM library
-		HRESULT hResult { CoInitializeEx(nullptr, COINIT_MULTITHREADED) };
+			while (Connection->bPending)
+			{
+				co_await GetExecutor().Sleep(std::chrono::milliseconds(WMI_POLL_INTERVAL));
+			}
 
-		if (FAILED(hResult)) 
-		{
-			return;
+			co_return Connection->Services;
 		}
 
+		auto Connection { std::make_shared <WMIConnection>() };
+		Connection->ServerName = ServerName;
+		Connections.push_back(Connection);
+
 		// Set security properties
-		hResult = CoInitializeSecurity(
+		HRESULT hResult { CoInitializeSecurity(
 			nullptr,
 			-1,
 			nullptr,
@@ -188,51 +366,89 @@ private:
 			nullptr,
 			EOAC_NONE,
 			nullptr
-		);
+		) };
 
-		if (FAILED(hResult))
+		// Security is set once per process, so later connections get RPC_E_TOO_LATE
+		if (FAILED(hResult) && hResult != RPC_E_TOO_LATE)
 		{
-			CoUninitialize();
-			return;
+			Connection->bPending = false;
+			co_return nullptr;
 		}
 
-		// Create COM instance
-		hResult = CoCreateInstance(
-			CLSID_WbemLocator,
-			NULL,
-			CLSCTX_INPROC_SERVER,
-			IID_IWbemLocator,
-			reinterpret_cast<PVOID*>(&Locator)
-		);
+		// Connect to the WMI server, connection blocks, so other queries go on meanwhile.
+		// A hung connection is abandoned at the deadline, the worker creates the locator itself, so it owns everything it uses
+		std::function <void()> Connect { [Connection]() {
+			Trace::Span ConnectSpan { "ConnectServer", "wmi", Connection->ServerName };
 
-		if (FAILED(hResult)) 
+			IWbemLocator* Locator {};
+			IWbemServices* Services {};
+			HRESULT Initialized { CoInitializeEx(nullptr, COINIT_MULTITHREADED) };
+			HRESULT Result { Initialized };
+
+			if (SUCCEEDED(Result))
+			{
+				Result = CoCreateInstance(
+					CLSID_WbemLocator,
+					NULL,
+					CLSCTX_INPROC_SERVER,
+					IID_IWbemLocator,
+					reinterpret_cast<PVOID*>(&Locator)
+				);
+
+				if (SUCCEEDED(Result))
+				{
+					Result = Locator->ConnectServer(
+						_bstr_t(Connection->ServerName.c_str()),
+						nullptr,
+						nullptr,
+						nullptr,
+						NULL,
+						nullptr,
+						nullptr,
+						&Services
+					);
+
+					Locator->Release();
+				}
+			}
+
+			// Result is written before the connection is claimed, the loop reads it only if the worker claimed it
+			Connection->hResult = Result;
+			Connection->Connected = SUCCEEDED(Result) ? Services : nullptr;
+
+			// Connection which returned after the query gave up isn't used by anybody
+			if (Connection->bClaimed.exchange(true) && Connection->Connected)
+			{
+				Connection->Connected->Release();
+			}
+
+			if (SUCCEEDED(Initialized))
+			{
+				CoUninitialize();
+			}
+		} };
+
+		co_await GetExecutor().Offload(std::move(Connect), std::min(Deadline, std::chrono::steady_clock::now() + std::chrono::milliseconds(WMI_QUERY_TIMEOUT)));
+
+		// Worker claims the connection first if it returned in time, otherwise it's abandoned here
+		bool bConnected { Connection->bClaimed.exchange(true) };
+		Connection->bPending = false;
+
+		// Only the abandoned connection means hung provider, failed one is just the failure of this namespace
+		if (!bConnected)
 		{
-			CoUninitialize();
-			return;
+			Wedged.push_back(ServerName);
+			co_return nullptr;
 		}
 
-		// Connect to the WMI server
-		hResult = Locator->ConnectServer(
-			_bstr_t(ServerName),
-			nullptr,
-			nullptr,
-			nullptr,
-			NULL,
-			nullptr,
-			nullptr,
-			&Services
-		);
-
-		if (FAILED(hResult)) 
+		if (FAILED(Connection->hResult) || !Connection->Connected)
 		{
-			Locator->Release();
-			CoUninitialize();
-			return;
+			co_return nullptr;
 		}
 
 		// Set proxy
 		hResult = CoSetProxyBlanket(
-			Services,
+			Connection->Connected,
 			RPC_C_AUTHN_WINNT,
 			RPC_C_AUTHZ_NONE,
 			nullptr,
@@ -244,39 +460,112 @@ private:
 
 		if (FAILED(hResult))
 		{
-			Services->Release();
-			Locator->Release();
-			CoUninitialize();
-			return;
+			Connection->Connected->Release();
+			co_return nullptr;
+		}
+
+		Connection->Services = Connection->Connected;
+
+		co_return Connection->Services;
+	}
+
+	/// <summary>
+	///		General query execute
+	/// </summary>
+	/// 
+	/// <typeparam name="T">Type</typeparam>
+	/// <param name="WMIClass">Class name</param>
+	/// <param name="Field">Filed name</param>
+	/// <param name="Value">Value</param>
+	/// <param name="ServerName">Server name</param>
+	/// 
+	/// <returns>Async::Task <bool>, false if the query failed, timed out or was cancelled</returns>
+	template <typename T = const wchar_t*>
+	Async::Task <bool> QueryWMI(std::wstring WMIClass, std::wstring Field, std::vector <T>& Value, const wchar_t* ServerName = L"ROOT\\CIMV2") 
+	{
+		Trace::AsyncSpan Span { "QueryWMI", "wmi", WMIClass, Field };
+
+		// Provider which timed out already would hang the next query too, so the query is skipped
+		if (bCancelled.load(std::memory_order_relaxed) || std::chrono::steady_clock::now() >= Deadline
+			|| std::find(Wedged.begin(), Wedged.end(), ServerName) != Wedged.end())
+		{
+			Value.resize(1);
+			co_return false;
+		}
+
+		// Build query
+		std::wstring Query(L"SELECT ");
+		Query.append(Field.c_str()).append(L" FROM ").append(WMIClass.c_str());
+
+		// Initialization
+		IWbemServices* Services { co_await ConnectWMI(ServerName) };
+		IEnumWbemClassObject* Enumerator {};
+		IWbemClassObject* ClassObject {};
+		VARIANT Variant {};
+		DWORD Returned {};
+		HRESULT hResult {};
+		bool bComplete { true };
+
+		if (!Services) 
+		{
+			Value.resize(1);
+			co_return false;
 		}
 
 		// Execute custom query
-		hResult = Services->ExecQuery(
-			bstr_t(L"WQL"),
-			bstr_t(Query.c_str()),
-			WBEM_FLAG_FORWARD_ONLY | WBEM_FLAG_RETURN_IMMEDIATELY,
-			nullptr,
-			&Enumerator
-		);
+		{
+			Trace::Span ExecSpan { "ExecQuery", "wmi", Query };
+
+			hResult = Services->ExecQuery(
+				bstr_t(L"WQL"),
+				bstr_t(Query.c_str()),
+				WBEM_FLAG_FORWARD_ONLY | WBEM_FLAG_RETURN_IMMEDIATELY,
+				nullptr,
+				&Enumerator
+			);
+		}
 
 		if (FAILED(hResult)) 
 		{
-			Services->Release();
-			Locator->Release();
-			CoUninitialize();
-			return;
+			Value.resize(1);
+			co_return false;
 		}
 
-		// Process result
+		// Process result, the query returns immediately, so results are waited for here
+		Trace::AsyncSpan EnumerateSpan { "Enumerate", "wmi", WMIClass };
+		auto QueryDeadline { std::min(Deadline, std::chrono::steady_clock::now() + std::chrono::milliseconds(WMI_QUERY_TIMEOUT)) };
+
 		while (Enumerator) 
 		{
+			// Results are polled without waiting, other queries run while this one is pending
+			long long Remaining { std::chrono::duration_cast <std::chrono::milliseconds>(QueryDeadline - std::chrono::steady_clock::now()).count() };
+
+			if (Remaining <= 0 || bCancelled.load(std::memory_order_relaxed)) 
+			{
+				// Values received so far are kept
+				bComplete = false;
+
+				if (Remaining <= 0) 
+				{
+					Wedged.push_back(ServerName);
+				}
+
+				break;
+			}
+
 			HRESULT Res { Enumerator->Next(
-				WBEM_INFINITE,
+				WBEM_NO_WAIT,
 				1,
 				&ClassObject,
 				&Returned
 			) };
 
+			if (Res == WBEM_S_TIMEDOUT) 
+			{
+				co_await GetExecutor().Sleep(std::chrono::milliseconds(WMI_POLL_INTERVAL));
+				continue;
+			}
+
 			if (!Returned) 
 			{
 				break;
@@ -318,28 +607,26 @@ private:
 			Value.resize(1);
 		}
 
-		// Free objects
-		Services->Release();
-		Locator->Release();
+		// Free objects, the connection is released by the collection
 		Enumerator->Release();
 
-		CoUninitialize();
+		co_return bComplete;
 	}
 
 	/// <summary>
 	///		Get disks information
 	/// </summary>
-	void QueryDisk() 
+	/// 
+	/// <returns>Async::Task <bool>, false if a query didn't complete</returns>
+	Async::Task <bool> QueryDisk() 
 	{
+		Trace::AsyncSpan Span { "QueryDisk", "collector" };
+
 		// Initialization
 		std::wstring DrivePath { L"\\\\.\\PhysicalDrive" };
 		std::wstring VolumePath { L"\\\\.\\" };
-		HANDLE hVolume { nullptr };
-		VOLUME_DISK_EXTENTS DiskExtents { NULL };
-		DWORD IoBytes { NULL };
-		ULARGE_INTEGER FreeBytesAvailable {};
-		ULARGE_INTEGER TotalBytes {};
 		int DriveCount { 0 };
+		bool bComplete { true };
 
 		std::vector <const wchar_t*> SerialNumber {};
 		std::vector <const wchar_t*> Model {};
@@ -350,115 +637,190 @@ private:
 		std::vector <const wchar_t*> FriendlyName {};
 		std::vector <unsigned int> MediaType {};
 		std::vector <bool> IsBoot {};
+		std::vector <int> VolumeDisk {};
 
-		// Get available physical disks
-		HANDLE Handle { nullptr };
-		for (;; DriveCount++) {
-			Handle = CreateFileW(
-				(DrivePath + std::to_wstring(DriveCount)).c_str(),
-				NULL,
-				NULL,
-				nullptr,
-				OPEN_EXISTING,
-				NULL,
-				nullptr
-			);
-			if (Handle == INVALID_HANDLE_VALUE) 
-			{ 
-				break; 
+		// Get available physical disks, device I/O is offloaded with everything it uses, so it's abandoned at the deadline if it hangs
+		auto Probed { std::make_shared <int>() };
+		std::function <void()> Probe { [Probed, DrivePath]() {
+			Trace::Span ProbeSpan { "ProbeDrives", "io", DrivePath };
+
+			for (;; (*Probed)++) {
+				HANDLE Handle { CreateFileW(
+					(DrivePath + std::to_wstring(*Probed)).c_str(),
+					NULL,
+					NULL,
+					nullptr,
+					OPEN_EXISTING,
+					NULL,
+					nullptr
+				) };
+				if (Handle == INVALID_HANDLE_VALUE) 
+				{ 
+					break; 
+				}
+
+				CloseHandle(Handle);
 			}
+		} };
 
-			CloseHandle(Handle);
+		if (co_await GetExecutor().Offload(std::move(Probe), Deadline)) 
+		{
+			DriveCount = *Probed;
+		}
+		else 
+		{
+			bComplete = false;
 		}
 
 		// Resize device container
 		this->Disk.resize(DriveCount);
 		SortedDeviceId.resize(DriveCount);
 
+		std::vector <ULARGE_INTEGER> FreeBytesAvailable(DriveCount);
+		std::vector <ULARGE_INTEGER> TotalBytes(DriveCount);
+
 		// To get most of the data we want, we make several queries to the Windows Management Instrumentation (WMI) service
 		// Queries to MSFT_PhysicalDisk and MSFT_Disk require a connection to the ROOT\\microsoft\\windows\\storage namespace
-		QueryWMI(L"Win32_DiskDrive", L"SerialNumber", SerialNumber);
-		QueryWMI(L"Win32_DiskDrive", L"Model", Model);
-		QueryWMI(L"Win32_DiskDrive", L"InterfaceType", Interface);
-		QueryWMI(L"Win32_DiskDrive", L"Name", Name);
-		QueryWMI(L"Win32_LogicalDisk", L"DeviceId", DeviceId);
-		QueryWMI(L"MSFT_PhysicalDisk", L"MediaType", MediaType, L"ROOT\\microsoft\\windows\\storage");
-		QueryWMI(L"MSFT_PhysicalDisk", L"FriendlyName", FriendlyName, L"ROOT\\microsoft\\windows\\storage");
-		QueryWMI(L"MSFT_Disk", L"IsBoot", IsBoot, L"ROOT\\microsoft\\windows\\storage");
+		std::vector <Async::Task <bool>> Queries {};
+
+		Queries.push_back(QueryWMI(L"Win32_DiskDrive", L"SerialNumber", SerialNumber));
+		Queries.push_back(QueryWMI(L"Win32_DiskDrive", L"Model", Model));
+		Queries.push_back(QueryWMI(L"Win32_DiskDrive", L"InterfaceType", Interface));
+		Queries.push_back(QueryWMI(L"Win32_DiskDrive", L"Name", Name));
+		Queries.push_back(QueryWMI(L"Win32_LogicalDisk", L"DeviceId", DeviceId));
+		Queries.push_back(QueryWMI(L"MSFT_PhysicalDisk", L"MediaType", MediaType, L"ROOT\\microsoft\\windows\\storage"));
+		Queries.push_back(QueryWMI(L"MSFT_PhysicalDisk", L"FriendlyName", FriendlyName, L"ROOT\\microsoft\\windows\\storage"));
+		Queries.push_back(QueryWMI(L"MSFT_Disk", L"IsBoot", IsBoot, L"ROOT\\microsoft\\windows\\storage"));
+
+		if (!co_await Async::WhenAll(std::move(Queries))) 
+		{
+			bComplete = false;
+		}
 
-		for (int i = 0; i < DriveCount; i++) 
+		// Queries could time out, so some values are missing
+		Pad(SerialNumber, DriveCount);
+		Pad(Model, DriveCount);
+		Pad(Interface, DriveCount);
+		Pad(Name, DriveCount);
+		Pad(MediaType, DriveCount);
+		Pad(FriendlyName, DriveCount);
+		Pad(IsBoot, DriveCount);
+
+		// Every volume is opened once, not once per disk
+		auto Extents { std::make_shared <std::vector <int>>() };
+		std::vector <std::wstring> Volumes {};
+
+		for (auto Volume : DeviceId) 
 		{
-			for (int j = 0; j < DriveCount; j++) 
+			Volumes.push_back(SafeString(Volume));
+		}
+
+		std::function <void()> Match { [Extents, Volumes = std::move(Volumes), VolumePath]() {
+			VOLUME_DISK_EXTENTS DiskExtents { NULL };
+			DWORD IoBytes { NULL };
+
+			for (auto& Volume : Volumes) 
 			{
+				Trace::Span VolumeSpan { "VolumeDiskExtents", "io", Volume };
+
 				// To get necessary letter name we need to find it using DeviceIoControl
-				hVolume = CreateFileW(
-					(VolumePath + DeviceId.at(j)).c_str(),
+				HANDLE hVolume { CreateFileW(
+					(VolumePath + Volume).c_str(),
 					NULL,
 					NULL,
 					nullptr,
 					OPEN_EXISTING,
 					NULL,
 					nullptr
-				);
+				) };
 
 				// IOCTL_VOLUME_GET_VOLUME_DISK_EXTENTS will fill our buffer with a VOLUME_DISK_EXTENTS structure
-				// First, we must get the number of disk extents
-				DeviceIoControl(
-					hVolume,
-					IOCTL_VOLUME_GET_VOLUME_DISK_EXTENTS,
-					nullptr,
-					NULL,
-					&DiskExtents,
-					sizeof(DiskExtents),
-					&IoBytes,
-					nullptr
-				);
-
 				// VOLUME_DISK_EXTENTS contains an array of DISK_EXTENT structures. DISK_EXTENT contains a DWORD member, DiskNumber
 				// DiskNumber will be the same number used to construct the name of the disk, which is PhysicalDriveX, where X is the DiskNumber
-				DeviceIoControl(
+				// The buffer holds one extent, volumes spanning several disks fail with ERROR_MORE_DATA,
+				// the first extent is filled anyway, so they are matched by it
+				bool bExtents { hVolume != INVALID_HANDLE_VALUE && (DeviceIoControl(
 					hVolume,
 					IOCTL_VOLUME_GET_VOLUME_DISK_EXTENTS,
 					nullptr,
 					NULL,
 					&DiskExtents,
-					offsetof(VOLUME_DISK_EXTENTS, Extents[DiskExtents.NumberOfDiskExtents]),
+					sizeof(DiskExtents),
 					&IoBytes,
 					nullptr
-				);
+				) || (GetLastError() == ERROR_MORE_DATA && DiskExtents.NumberOfDiskExtents)) };
 
-				CloseHandle(hVolume);
+				Extents->push_back(bExtents ? (int)DiskExtents.Extents[0].DiskNumber : -1);
 
-				// To map the drive letter from Win32_LogicalDisk to the data returned by Win32_DiskDrive
-				// We compare the drive letter's DiskNumber to the number at the end of the "Name" we recieve from Win32_DiskDrive
-				// We then reorder the drive letters accordingly
-				if (DiskExtents.Extents->DiskNumber == std::stoi(&SafeString(Name.at(i)).back())) 
+				if (hVolume != INVALID_HANDLE_VALUE) 
 				{
-					SortedDeviceId.at(i) = DeviceId.at(j);
-					break;
+					CloseHandle(hVolume);
 				}
 			}
+		} };
+
+		if (co_await GetExecutor().Offload(std::move(Match), Deadline)) 
+		{
+			VolumeDisk = *Extents;
+		}
+		else 
+		{
+			VolumeDisk.assign(DeviceId.size(), -1);
+			bComplete = false;
 		}
 
+		// To map the drive letter from Win32_LogicalDisk to the data returned by Win32_DiskDrive
+		// We compare the drive letter's DiskNumber to the number at the end of the "Name" we recieve from Win32_DiskDrive
+		// We then reorder the drive letters accordingly
+		MatchVolumes(Name, VolumeDisk, DeviceId, SortedDeviceId);
+
 		this->Disk.resize(DriveCount);
 
+		// Give the size and free space available corresponding to the drive letters we have
+		auto Space { std::make_shared <std::vector <ULARGE_INTEGER>>(DriveCount * 2) };
+		std::vector <std::wstring> Letters {};
+
 		for (int i = 0; i < DriveCount; i++) 
 		{
-			// Give the size and free space available corresponding to the drive letters we have
-			GetDiskFreeSpaceEx(
-				SafeString(SortedDeviceId.at(i)).c_str(),
-				&FreeBytesAvailable,
-				&TotalBytes,
-				nullptr
-			);
+			Letters.push_back(SafeString(SortedDeviceId.at(i)));
+		}
+
+		std::function <void()> Measure { [Space, Letters = std::move(Letters)]() {
+			for (size_t i = 0; i < Letters.size(); i++) 
+			{
+				Trace::Span FreeSpaceSpan { "GetDiskFreeSpaceEx", "io", Letters.at(i) };
 
+				GetDiskFreeSpaceEx(
+					Letters.at(i).c_str(),
+					&Space->at(i * 2),
+					&Space->at(i * 2 + 1),
+					nullptr
+				);
+			}
+		} };
+
+		if (co_await GetExecutor().Offload(std::move(Measure), Deadline)) 
+		{
+			for (int i = 0; i < DriveCount; i++) 
+			{
+				FreeBytesAvailable.at(i) = Space->at(i * 2);
+				TotalBytes.at(i) = Space->at(i * 2 + 1);
+			}
+		}
+		else 
+		{
+			bComplete = false;
+		}
+
+		for (int i = 0; i < DriveCount; i++) 
+		{
 			// Save characteristics
 			RemoveWhitespaces(this->Disk.at(i).SerialNumber = SafeString(SerialNumber.at(i)));
 			this->Disk.at(i).Model = SafeString(Model.at(i));
 			this->Disk.at(i).Interface = SafeString(Interface.at(i));
 			this->Disk.at(i).DriveLetter = SafeString(SortedDeviceId.at(i));
-			this->Disk.at(i).Size = TotalBytes.QuadPart / pow(1024, 3);
-			this->Disk.at(i).FreeSpace = FreeBytesAvailable.QuadPart / pow(1024, 3);
+			this->Disk.at(i).Size = TotalBytes.at(i).QuadPart / pow(1024, 3);
+			this->Disk.at(i).FreeSpace = FreeBytesAvailable.at(i).QuadPart / pow(1024, 3);
 			this->Disk.at(i).IsBootDrive = IsBoot.at(i);
 
 			// Data from MSFT_PhysicalDisk will not be in the same order as Win32_DiskDrive
@@ -466,19 +828,25 @@ private:
 			// We then reorder the data accordingly
 			for (int j = 0; j < DriveCount; j++) 
 			{
-				if (!this->Disk.at(i).Model.compare(FriendlyName.at(j))) 
+				if (FriendlyName.at(j) && !this->Disk.at(i).Model.compare(FriendlyName.at(j))) 
 				{
 					this->Disk.at(i).MediaType = MediaType.at(j);
 				}
 			}
 		}
+
+		co_return bComplete;
 	}
 
 	/// <summary>
 	///		Get SMBIOS information
 	/// </summary>
-	void QuerySMBIOS() 
+	/// 
+	/// <returns>Async::Task <bool>, false if a query didn't complete</returns>
+	Async::Task <bool> QuerySMBIOS() 
 	{
+		Trace::AsyncSpan Span { "QuerySMBIOS", "collector" };
+
 		// Initialization
 		std::vector <const wchar_t*> Manufacturer {};
 		std::vector <const wchar_t*> Product {};
@@ -486,23 +854,33 @@ private:
 		std::vector <const wchar_t*> SerialNumber {};
 
 		// Get information
-		QueryWMI(L"Win32_BaseBoard", L"Manufacturer", Manufacturer);
-		QueryWMI(L"Win32_BaseBoard", L"Product", Product);
-		QueryWMI(L"Win32_BaseBoard", L"Version", Version);
-		QueryWMI(L"Win32_BaseBoard", L"SerialNumber", SerialNumber);
+		std::vector <Async::Task <bool>> Queries {};
+
+		Queries.push_back(QueryWMI(L"Win32_BaseBoard", L"Manufacturer", Manufacturer));
+		Queries.push_back(QueryWMI(L"Win32_BaseBoard", L"Product", Product));
+		Queries.push_back(QueryWMI(L"Win32_BaseBoard", L"Version", Version));
+		Queries.push_back(QueryWMI(L"Win32_BaseBoard", L"SerialNumber", SerialNumber));
+
+		bool bComplete { co_await Async::WhenAll(std::move(Queries)) };
 
 		// Save characteristics
 		this->SMBIOS.Manufacturer = SafeString(Manufacturer.at(0));
 		this->SMBIOS.Product = SafeString(Product.at(0));
 		this->SMBIOS.Version = SafeString(Version.at(0));
 		this->SMBIOS.SerialNumber = SafeString(SerialNumber.at(0));
+
+		co_return bComplete;
 	}
 
 	/// <summary>
 	///		Get CPU information
 	/// </summary>
-	void QueryProcessor() 
+	/// 
+	/// <returns>Async::Task <bool>, false if a query didn't complete</returns>
+	Async::Task <bool> QueryProcessor() 
 	{
+		Trace::AsyncSpan Span { "QueryProcessor", "collector" };
+
 		// Initialization
 		std::vector <const wchar_t*> ProcessorId {};
 		std::vector <const wchar_t*> Manufacturer {};
@@ -511,11 +889,15 @@ private:
 		std::vector <int> Threads {};
 
 		// Get information
-		QueryWMI(L"Win32_Processor", L"ProcessorId", ProcessorId);
-		QueryWMI(L"Win32_Processor", L"Manufacturer", Manufacturer);
-		QueryWMI(L"Win32_Processor", L"Name", Name);
-		QueryWMI<int>(L"Win32_Processor", L"NumberOfCores", Cores);
-		QueryWMI<int>(L"Win32_Processor", L"NumberOfLogicalProcessors", Threads);
+		std::vector <Async::Task <bool>> Queries {};
+
+		Queries.push_back(QueryWMI(L"Win32_Processor", L"ProcessorId", ProcessorId));
+		Queries.push_back(QueryWMI(L"Win32_Processor", L"Manufacturer", Manufacturer));
+		Queries.push_back(QueryWMI(L"Win32_Processor", L"Name", Name));
+		Queries.push_back(QueryWMI<int>(L"Win32_Processor", L"NumberOfCores", Cores));
+		Queries.push_back(QueryWMI<int>(L"Win32_Processor", L"NumberOfLogicalProcessors", Threads));
+
+		bool bComplete { co_await Async::WhenAll(std::move(Queries)) };
 
 		// Save characteristics
 		this->CPU.ProcessorId = SafeString(ProcessorId.at(0));
@@ -523,13 +905,19 @@ private:
 		this->CPU.Name = SafeString(Name.at(0));
 		this->CPU.Cores = Cores.at(0);
 		this->CPU.Threads = Threads.at(0);
+
+		co_return bComplete;
 	}
 
 	/// <summary>
 	///		Get GPU information
 	/// </summary>
-	void QueryGPU() 
+	/// 
+	/// <returns>Async::Task <bool>, false if a query didn't complete</returns>
+	Async::Task <bool> QueryGPU() 
 	{
+		Trace::AsyncSpan Span { "QueryGPU", "collector" };
+
 		// Initialization
 		std::vector <const wchar_t*> Name{};
 		std::vector <const wchar_t*> DriverVersion{};
@@ -538,11 +926,21 @@ private:
 		std::vector <int> RefreshRate{};
 
 		// Get information
-		QueryWMI(L"Win32_VideoController", L"Name", Name);
-		QueryWMI(L"Win32_VideoController", L"DriverVersion", DriverVersion);
-		QueryWMI(L"Win32_VideoController", L"CurrentHorizontalResolution", XRes);
-		QueryWMI(L"Win32_VideoController", L"CurrentVerticalResolution", YRes);
-		QueryWMI(L"Win32_VideoController", L"CurrentRefreshRate", RefreshRate);
+		std::vector <Async::Task <bool>> Queries {};
+
+		Queries.push_back(QueryWMI(L"Win32_VideoController", L"Name", Name));
+		Queries.push_back(QueryWMI(L"Win32_VideoController", L"DriverVersion", DriverVersion));
+		Queries.push_back(QueryWMI(L"Win32_VideoController", L"CurrentHorizontalResolution", XRes));
+		Queries.push_back(QueryWMI(L"Win32_VideoController", L"CurrentVerticalResolution", YRes));
+		Queries.push_back(QueryWMI(L"Win32_VideoController", L"CurrentRefreshRate", RefreshRate));
+
+		bool bComplete { co_await Async::WhenAll(std::move(Queries)) };
+
+		// Queries could time out, so some values are missing
+		Pad(DriverVersion, Name.size());
+		Pad(XRes, Name.size());
+		Pad(YRes, Name.size());
+		Pad(RefreshRate, Name.size());
 
 		// Save characteristics
 		this->GPU.resize(Name.size());
@@ -555,13 +953,19 @@ private:
 			this->GPU.at(i).YResolution = YRes.at(i);
 			this->GPU.at(i).RefreshRate = RefreshRate.at(i);
 		}
+
+		co_return bComplete;
 	}
 
 	/// <summary>
 	///		Get OS information
 	/// </summary>
-	void QuerySystem() 
+	/// 
+	/// <returns>Async::Task <bool>, false if a query didn't complete</returns>
+	Async::Task <bool> QuerySystem() 
 	{
+		Trace::AsyncSpan Span { "QuerySystem", "collector" };
+
 		// Initialization
 		std::vector <const wchar_t*> SystemName{};
 		std::vector <const wchar_t*> OSVersion{};
@@ -571,12 +975,16 @@ private:
 		std::vector <bool> IsHypervisorPresent{};
 
 		// Get information
-		QueryWMI(L"Win32_ComputerSystem", L"Name", SystemName);
-		QueryWMI(L"Win32_ComputerSystem", L"Model", IsHypervisorPresent);
-		QueryWMI(L"Win32_OperatingSystem", L"Version", OSVersion);
-		QueryWMI(L"Win32_OperatingSystem", L"Name", OSName);
-		QueryWMI(L"Win32_OperatingSystem", L"OSArchitecture", OSArchitecture);
-		QueryWMI(L"Win32_OperatingSystem", L"SerialNumber", OSSerialNumber);
+		std::vector <Async::Task <bool>> Queries {};
+
+		Queries.push_back(QueryWMI(L"Win32_ComputerSystem", L"Name", SystemName));
+		Queries.push_back(QueryWMI(L"Win32_ComputerSystem", L"Model", IsHypervisorPresent));
+		Queries.push_back(QueryWMI(L"Win32_OperatingSystem", L"Version", OSVersion));
+		Queries.push_back(QueryWMI(L"Win32_OperatingSystem", L"Name", OSName));
+		Queries.push_back(QueryWMI(L"Win32_OperatingSystem", L"OSArchitecture", OSArchitecture));
+		Queries.push_back(QueryWMI(L"Win32_OperatingSystem", L"SerialNumber", OSSerialNumber));
+
+		bool bComplete { co_await Async::WhenAll(std::move(Queries)) };
 
 		// Save characteristics
 		std::wstring wOSName{ SafeString(OSName.at(0)) };
@@ -589,20 +997,33 @@ private:
 		this->System.OSVersion = SafeString(OSVersion.at(0));
 		this->System.OSSerialNumber = SafeString(OSSerialNumber.at(0));
 		this->System.OSArchitecture = SafeString(OSArchitecture.at(0));
+
+		co_return bComplete;
 	}
 
 	/// <summary>
 	///		Get network information
 	/// </summary>
-	void QueryNetwork() 
+	/// 
+	/// <returns>Async::Task <bool>, false if a query didn't complete</returns>
+	Async::Task <bool> QueryNetwork() 
 	{
+		Trace::AsyncSpan Span { "QueryNetwork", "collector" };
+
 		// Initialization
 		std::vector <const wchar_t*> Name{};
 		std::vector <const wchar_t*> MAC{};
 
 		// Get information
-		QueryWMI(L"Win32_NetworkAdapter", L"Name", Name);
-		QueryWMI(L"Win32_NetworkAdapter", L"MACAddress", MAC);
+		std::vector <Async::Task <bool>> Queries {};
+
+		Queries.push_back(QueryWMI(L"Win32_NetworkAdapter", L"Name", Name));
+		Queries.push_back(QueryWMI(L"Win32_NetworkAdapter", L"MACAddress", MAC));
+
+		bool bComplete { co_await Async::WhenAll(std::move(Queries)) };
+
+		// Query could time out, so some values are missing
+		Pad(MAC, Name.size());
 
 		// Save characteristics
 		this->NetworkAdapter.resize(Name.size());
@@ -611,11 +1032,19 @@ private:
 			this->NetworkAdapter.at(i).Name = SafeString(Name.at(i));
 			this->NetworkAdapter.at(i).MAC = SafeString(MAC.at(i));
 		}
+
+		co_return bComplete;
 	}
 
-	// Get memory information
-	void QueryPhysicalMemory() 
+	/// <summary>
+	///		Get memory information
+	/// </summary>
+	/// 
+	/// <returns>Async::Task <bool>, false if a query didn't complete</returns>
+	Async::Task <bool> QueryPhysicalMemory() 
 	{
+		Trace::AsyncSpan Span { "QueryPhysicalMemory", "collector" };
+
 		// Initialization
 		std::vector<const wchar_t*> PartNumber{};
 
@@ -623,7 +1052,11 @@ private:
 		MEMORYSTATUSEX memStat;
 		memStat.dwLength = sizeof(memStat);
 		GlobalMemoryStatusEx(&memStat);
-		QueryWMI(L"Win32_PhysicalMemory", L"PartNumber", PartNumber);
+		std::vector <Async::Task <bool>> Queries {};
+
+		Queries.push_back(QueryWMI(L"Win32_PhysicalMemory", L"PartNumber", PartNumber));
+
+		bool bComplete { co_await Async::WhenAll(std::move(Queries)) };
 
 		// Save characteristics
 		this->PhysicalMemory.PartNumber = SafeString(PartNumber.at(0));
@@ -633,34 +1066,149 @@ private:
 		this->PhysicalMemory.AvailableVirtualSize = memStat.ullAvailVirtual / MB;
 		this->PhysicalMemory.TotalPageSize = memStat.ullTotalPageFile / MB;
 		this->PhysicalMemory.AvailablePageSize = memStat.ullAvailPageFile / MB;
+
+		co_return bComplete;
 	}
 
 	/// <summary>
 	///		Get information from registry
 	/// </summary>
-	void QueryRegistry() 
+	/// 
+	/// <returns>Async::Task <bool>, false if a query didn't complete</returns>
+	Async::Task <bool> QueryRegistry() 
 	{
+		Trace::Span Span { "QueryRegistry", "collector" };
+
 		// Save hardware id
 		this->Registry.ComputerHardwareId = SafeString(GetHKLM(L"SYSTEM\\CurrentControlSet\\Control\\SystemInformation", L"ComputerHardwareId").c_str());
 		this->Registry.ComputerManufacturer = SafeString(GetHKLM(L"SYSTEM\\CurrentControlSet\\Control\\SystemInformation", L"SystemManufacturer").c_str());
 		this->Registry.ComputerName = SafeString(GetHKLM(L"SYSTEM\\CurrentControlSet\\Control\\SystemInformation", L"SystemProductName").c_str());
+
+		co_return true;
 	}
 
 	/// <summary>
-	///		Get all information
+	///		Get collection executor, queries of all collectors share its loop thread
 	/// </summary>
-	void GetComputerStatistics() 
+	/// 
+	/// <returns>Async::Executor&</returns>
+	static Async::Executor& GetExecutor()
 	{
-		QueryDisk();
-		QuerySMBIOS();
-		QueryProcessor();
-		QueryGPU();
-		QuerySystem();
-		QueryNetwork();
-		QueryPhysicalMemory();
-		QueryRegistry();
+		static Async::Executor Instance {};
+
+		return Instance;
+	}
+
+	/// <summary>
+	///		Get requested information, the calling thread waits until the collection completes
+	/// </summary>
+	/// 
+	/// <param name="Categories">Categories flags</param>
+	void GetComputerStatistics(unsigned int Categories) 
+	{
+		Trace::Span Span { "GetComputerStatistics", "collector" };
+
+		GetExecutor().Run(Collect(Categories));
+	}
+
+	/// <summary>
+	///		Collect category if it's requested and mark it stale if it's incomplete
+	/// </summary>
+	/// 
+	/// <param name="Categories">Requested categories flags</param>
+	/// <param name="Category">Category flag</param>
+	/// <param name="Collector">Collector</param>
+	/// 
+	/// <returns>Async::Task <bool>, false if the category is incomplete</returns>
+	Async::Task <bool> CollectCategory(unsigned int Categories, unsigned int Category, Async::Task <bool> (ComputerStatistics::*Collector)()) 
+	{
+		if (!(Categories & Category)) 
+		{
+			co_return true;
+		}
+
+		bool bComplete { co_await (this->*Collector)() };
+
+		Stale = bComplete ? Stale & ~Category : Stale | Category;
+
+		co_return bComplete;
 	}
 
+public:
+
+	/// <summary>
+	///		Collect requested categories on the collection executor, collectors and their queries overlap.
+	///		Consumers running on the executor await it directly, others call Update or Refresh
+	/// </summary>
+	/// 
+	/// <param name="Categories">Categories flags</param>
+	/// 
+	/// <returns>Async::Task <bool>, false if any category is incomplete</returns>
+	Async::Task <bool> Collect(unsigned int Categories) 
+	{
+		std::vector <Async::Task <bool>> Collectors {};
+
+		// Collection deadline bounds startup even if every query hangs
+		Deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(COLLECTION_TIMEOUT);
+		bCancelled.store(false, std::memory_order_relaxed);
+		Wedged.clear();
+
+		// COM stays initialized on the loop thread for the collection, namespace connections are released at its end
+		HRESULT hResult { CoInitializeEx(nullptr, COINIT_MULTITHREADED) };
+
+		Collectors.push_back(CollectCategory(Categories, eQueryDisk, &ComputerStatistics::QueryDisk));
+		Collectors.push_back(CollectCategory(Categories, eQuerySMBIOS, &ComputerStatistics::QuerySMBIOS));
+		Collectors.push_back(CollectCategory(Categories, eQueryCPU, &ComputerStatistics::QueryProcessor));
+		Collectors.push_back(CollectCategory(Categories, eQueryGPU, &ComputerStatistics::QueryGPU));
+		Collectors.push_back(CollectCategory(Categories, eQuerySystem, &ComputerStatistics::QuerySystem));
+		Collectors.push_back(CollectCategory(Categories, eQueryNetwork, &ComputerStatistics::QueryNetwork));
+		Collectors.push_back(CollectCategory(Categories, eQueryPhysicalMemory, &ComputerStatistics::QueryPhysicalMemory));
+		Collectors.push_back(CollectCategory(Categories, eQueryRegistry, &ComputerStatistics::QueryRegistry));
+
+		bool bComplete { co_await Async::WhenAll(std::move(Collectors)) };
+
+		for (auto& Connection : Connections)
+		{
+			if (Connection->Services)
+			{
+				Connection->Services->Release();
+			}
+		}
+
+		Connections.clear();
+
+		if (SUCCEEDED(hResult))
+		{
+			CoUninitialize();
+		}
+
+		co_return bComplete;
+	}
+#else
+private:
+
+	/// <summary>
+	///		Inventory isn't collected outside Windows, records are filled by loading snapshots, e.g. in benchmarks
+	/// </summary>
+	/// 
+	/// <param name="Categories">Categories flags</param>
+	void GetComputerStatistics(unsigned int) {}
+
+public:
+
+	/// <summary>
+	///		Collect requested categories, nothing is collected outside Windows
+	/// </summary>
+	/// 
+	/// <param name="Categories">Categories flags</param>
+	/// 
+	/// <returns>Async::Task <bool></returns>
+	Async::Task <bool> Collect(unsigned int) 
+	{
+		co_return true;
+	}
+#endif
+
 public:
 
 	/// <summary>
@@ -681,7 +1229,7 @@ public:
 	/// <summary>
 	///		SMBIOS information
 	/// </summary>
-	struct 
+	struct SMBIOSObject 
 	{
 		std::wstring Manufacturer {};
 		std::wstring Product {};
@@ -692,7 +1240,7 @@ public:
 	/// <summary>
 	///		CPU information
 	/// </summary>
-	struct 
+	struct CPUObject 
 	{
 		std::wstring ProcessorId {};
 		std::wstring Manufacturer {};
@@ -725,7 +1273,7 @@ public:
 	/// <summary>
 	///		OS information
 	/// </summary>
-	struct 
+	struct SystemObject 
 	{
 		std::wstring Name {};
 		bool IsHypervisorPresent {};
@@ -738,7 +1286,7 @@ public:
 	/// <summary>
 	///		Memory information
 	/// </summary>
-	struct 
+	struct PhysicalMemoryObject 
 	{
 		std::wstring PartNumber {};
 		float TotalSize {};
@@ -752,7 +1300,7 @@ public:
 	/// <summary>
 	///		Hardware id information
 	/// </summary>
-	struct 
+	struct RegistryObject 
 	{
 		std::wstring ComputerHardwareId{};
 		std::wstring ComputerManufacturer {};
@@ -764,6 +1312,52 @@ public:
 	/// </summary>
 	ComputerStatistics() 
 	{
-		GetComputerStatistics();
+		GetComputerStatistics(eQueryAll);
+	}
+
+	/// <summary>
+	///		Constructor, gets only requested categories
+	/// </summary>
+	/// 
+	/// <param name="Categories">Categories flags</param>
+	explicit ComputerStatistics(unsigned int Categories) 
+	{
+		GetComputerStatistics(Categories);
+	}
+
+	/// <summary>
+	///		Collect categories again, e.g. after hardware was plugged in or removed, other categories are kept
+	/// </summary>
+	/// 
+	/// <param name="Categories">Categories flags</param>
+	void Refresh(unsigned int Categories) 
+	{
+		if (Categories & eQueryDisk) 
+		{
+			this->Disk.clear();
+		}
+
+		if (Categories & eQueryGPU) 
+		{
+			this->GPU.clear();
+		}
+
+		if (Categories & eQueryNetwork) 
+		{
+			this->NetworkAdapter.clear();
+		}
+
+		GetComputerStatistics(Categories);
 	}
+
+private:
+
+	unsigned int Stale {};
+	std::vector <std::wstring> Wedged {};
+	std::chrono::steady_clock::time_point Deadline {};
+#ifdef _WIN32
+	std::vector <std::shared_ptr <WMIConnection>> Connections {};
+#endif
+
+	static inline std::atomic <bool> bCancelled {};
 };
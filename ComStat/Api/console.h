@@ -0,0 +1,265 @@
+#pragma once
+
+#include <cwchar>
+#include <iostream>
+#include <string>
+#include <windows.h>
+#include "../Api/serializer.h"
+
+/// <summary>
+///		Buffered console output, the whole response is written at once
+/// </summary>
+class ConsoleOutput
+{
+
+public:
+
+	/// <summary>
+	///		Append string
+	/// </summary>
+	/// 
+	/// <param name="String">Input string</param>
+	/// 
+	/// <returns>ConsoleOutput&</returns>
+	ConsoleOutput& operator << (const std::wstring& String)
+	{
+		Buffer.append(String);
+
+		return *this;
+	}
+
+	/// <summary>
+	///		Append string
+	/// </summary>
+	/// 
+	/// <param name="String">Input string</param>
+	/// 
+	/// <returns>ConsoleOutput&</returns>
+	ConsoleOutput& operator << (const wchar_t* String)
+	{
+		Buffer.append(String);
+
+		return *this;
+	}
+
+	/// <summary>
+	///		Append narrow string, e.g. std::ctime result
+	/// </summary>
+	/// 
+	/// <param name="String">Input string</param>
+	/// 
+	/// <returns>ConsoleOutput&</returns>
+	ConsoleOutput& operator << (const char* String)
+	{
+		for (; *String; String++)
+		{
+			Buffer.push_back((unsigned char)*String);
+		}
+
+		return *this;
+	}
+
+	/// <summary>
+	///		Append boolean as 1 or 0, like std::wcout does
+	/// </summary>
+	/// 
+	/// <param name="Value">Value</param>
+	/// 
+	/// <returns>ConsoleOutput&</returns>
+	ConsoleOutput& operator << (bool Value)
+	{
+		Buffer.push_back(Value ? L'1' : L'0');
+
+		return *this;
+	}
+
+	/// <summary>
+	///		Append integer
+	/// </summary>
+	/// 
+	/// <param name="Value">Value</param>
+	/// 
+	/// <returns>ConsoleOutput&</returns>
+	ConsoleOutput& operator << (long long Value)
+	{
+		Buffer.append(std::to_wstring(Value));
+
+		return *this;
+	}
+
+	/// <summary>
+	///		Append integer
+	/// </summary>
+	/// 
+	/// <param name="Value">Value</param>
+	/// 
+	/// <returns>ConsoleOutput&</returns>
+	ConsoleOutput& operator << (int Value)
+	{
+		return *this << (long long)Value;
+	}
+
+	/// <summary>
+	///		Append integer
+	/// </summary>
+	/// 
+	/// <param name="Value">Value</param>
+	/// 
+	/// <returns>ConsoleOutput&</returns>
+	ConsoleOutput& operator << (unsigned int Value)
+	{
+		return *this << (long long)Value;
+	}
+
+	/// <summary>
+	///		Append floating point value with 6 significant digits, like std::wcout does
+	/// </summary>
+	/// 
+	/// <param name="Value">Value</param>
+	/// 
+	/// <returns>ConsoleOutput&</returns>
+	ConsoleOutput& operator << (double Value)
+	{
+		wchar_t Number[32] {};
+		int Length { swprintf(Number, sizeof(Number) / sizeof(Number[0]), L"%g", Value) };
+
+		Buffer.append(Number, Length > 0 ? Length : 0);
+
+		return *this;
+	}
+
+	/// <summary>
+	///		Append floating point value
+	/// </summary>
+	/// 
+	/// <param name="Value">Value</param>
+	/// 
+	/// <returns>ConsoleOutput&</returns>
+	ConsoleOutput& operator << (float Value)
+	{
+		return *this << (double)Value;
+	}
+
+	/// <summary>
+	///		Append raw bytes, e.g. UTF-8 document, they are written as is after the text buffered before them
+	/// </summary>
+	/// 
+	/// <param name="Bytes">Bytes</param>
+	void Write(const std::string& Bytes)
+	{
+		if (!Buffer.empty())
+		{
+			Flush();
+		}
+
+		Raw.append(Bytes);
+	}
+
+	/// <summary>
+	///		Write buffered bytes and text with one call each
+	/// </summary>
+	void Flush()
+	{
+		DWORD Mode {};
+		DWORD Written {};
+		HANDLE Handle { GetStdHandle(STD_OUTPUT_HANDLE) };
+
+		// Captured text stays in the buffer as UTF-8 after the bytes before it
+		if (bCapture)
+		{
+			Serializer::AppendUTF8(Raw, Buffer);
+			Buffer.clear();
+
+			return;
+		}
+
+		// Raw bytes always precede buffered text, no console code page or newline translation
+		if (!Raw.empty())
+		{
+			WriteFile(Handle, Raw.data(), (DWORD)Raw.size(), &Written, nullptr);
+			Raw.clear();
+		}
+
+		if (Buffer.empty())
+		{
+			return;
+		}
+
+		// Redirected output keeps std::wcout locale conversion
+		if (GetConsoleMode(Handle, &Mode))
+		{
+			WriteConsoleW(Handle, Buffer.data(), (DWORD)Buffer.size(), &Written, nullptr);
+		}
+		else
+		{
+			std::wcout.write(Buffer.data(), Buffer.size());
+			std::wcout.flush();
+		}
+
+		Buffer.clear();
+	}
+
+	/// <summary>
+	///		Write buffered text and change text color
+	/// </summary>
+	/// 
+	/// <param name="Color">Color attributes</param>
+	void SetColor(WORD Color)
+	{
+		Flush();
+
+		if (!bCapture)
+		{
+			SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), Color);
+		}
+	}
+
+	/// <summary>
+	///		Keep output in memory instead of writing it to console, e.g. to send it to a client
+	/// </summary>
+	/// 
+	/// <param name="IsCapture">Capture output</param>
+	void SetCapture(bool IsCapture)
+	{
+		Flush();
+		bCapture = IsCapture;
+	}
+
+	/// <summary>
+	///		Move captured output as UTF-8 bytes
+	/// </summary>
+	/// 
+	/// <param name="Bytes">Output bytes</param>
+	void Take(std::string& Bytes)
+	{
+		Flush();
+		Bytes.append(Raw);
+		Raw.clear();
+	}
+
+	/// <summary>
+	///		Get buffered text
+	/// </summary>
+	/// 
+	/// <returns>const std::wstring&</returns>
+	const std::wstring& GetBuffer() const
+	{
+		return Buffer;
+	}
+
+	/// <summary>
+	///		Get buffered symbols and bytes count
+	/// </summary>
+	/// 
+	/// <returns>size_t</returns>
+	size_t GetSize() const
+	{
+		return Buffer.size() + Raw.size();
+	}
+
+private:
+
+	std::wstring Buffer {};
+	std::string Raw {};
+	bool bCapture {};
+};
@@ -0,0 +1,421 @@
+#pragma once
+#pragma comment(lib, "iphlpapi.lib")
+#pragma comment(lib, "ntdll.lib")
+
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <ctime>
+#include <cwchar>
+#include <string>
+#include <vector>
+#include <winsock2.h>
+#include <windows.h>
+#include <winternl.h>
+#include <iphlpapi.h>
+#include "../Api/alert.h"
+#include "../Api/comstat.h"
+#include "../Api/console.h"
+#include "../Api/screen.h"
+
+#define DASHBOARD_FRAME_INTERVAL 100
+#define DASHBOARD_BAR_WIDTH 22
+#define DASHBOARD_CORE_WIDTH 40
+#define DASHBOARD_NAME_WIDTH 24
+
+/// <summary>
+///		Full-screen realtime dashboard: per core CPU load, memory, free space of disks and network throughput in fixed positions.
+///		Frames are drawn into a ScreenBuffer, so only changed cells are written to the console
+/// </summary>
+class Dashboard
+{
+
+public:
+
+	/// <summary>
+	///		Destructor
+	/// </summary>
+	~Dashboard()
+	{
+		Stop();
+	}
+
+	/// <summary>
+	///		Switch console to the alternate screen, it fails if output isn't a console or it doesn't process ANSI escape sequences
+	/// </summary>
+	/// 
+	/// <param name="Console">Console output</param>
+	/// 
+	/// <returns>bool</returns>
+	bool Start(ConsoleOutput& Console)
+	{
+		SYSTEM_INFO Info {};
+		HANDLE Handle { GetStdHandle(STD_OUTPUT_HANDLE) };
+
+		if (Output || !GetConsoleMode(Handle, &Mode)
+			|| !SetConsoleMode(Handle, Mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING | DISABLE_NEWLINE_AUTO_RETURN))
+		{
+			return false;
+		}
+
+		GetSystemInfo(&Info);
+
+		Times.resize(Info.dwNumberOfProcessors);
+		PreviousTimes.resize(Info.dwNumberOfProcessors);
+		CoreLoads.assign(Info.dwNumberOfProcessors, 0.0f);
+		bSampled = false;
+
+		Output = &Console;
+		Screen.Resize(0, 0);
+
+		// Alternate screen keeps the history of the console, cursor is hidden while frames are drawn
+		Console.Flush();
+		Console << L"\x1b[?1049h\x1b[?25l";
+		Console.Flush();
+
+		return true;
+	}
+
+	/// <summary>
+	///		Restore console screen and mode
+	/// </summary>
+	void Stop()
+	{
+		if (!Output)
+		{
+			return;
+		}
+
+		*Output << L"\x1b[0m\x1b[?25h\x1b[?1049l";
+		Output->Flush();
+
+		SetConsoleMode(GetStdHandle(STD_OUTPUT_HANDLE), Mode);
+		Output = nullptr;
+	}
+
+	/// <summary>
+	///		Sample free space of disks and network throughput, they are slower to get than CPU and memory load, so it's called once per second
+	/// </summary>
+	/// 
+	/// <param name="HWID">Collected statistics</param>
+	void SampleDevices(ComputerStatistics& HWID)
+	{
+		auto Now { std::chrono::steady_clock::now() };
+		double Seconds { std::chrono::duration <double>(Now - DevicesTime).count() };
+		MIB_IF_TABLE2* Table {};
+
+		Drives.clear();
+
+		for (auto& Disk : HWID.Disk)
+		{
+			if (Disk.DriveLetter.size())
+			{
+				Drives.push_back({ Disk.DriveLetter, (float)Disk.Size, HWID.GetFreeSpace(Disk.DriveLetter) });
+			}
+		}
+
+		for (auto& Adapter : Adapters)
+		{
+			Adapter.bPresent = false;
+		}
+
+		if (GetIfTable2(&Table) == NO_ERROR)
+		{
+			for (ULONG i = 0; i < Table->NumEntries; i++)
+			{
+				auto& Row { Table->Table[i] };
+
+				// Physical adapters only, virtual filters and loopback repeat the same traffic
+				if (!Row.InterfaceAndOperStatusFlags.HardwareInterface || Row.OperStatus != IfOperStatusUp || Row.Type == IF_TYPE_SOFTWARE_LOOPBACK)
+				{
+					continue;
+				}
+
+				auto Adapter { std::find_if(Adapters.begin(), Adapters.end(), [&](const NetworkAdapter& Known) { return Known.Luid == Row.InterfaceLuid.Value; }) };
+
+				if (Adapter == Adapters.end())
+				{
+					Adapters.push_back({ Row.InterfaceLuid.Value, Row.Alias, Row.InOctets, Row.OutOctets });
+					Adapter = Adapters.end() - 1;
+				}
+				else if (Seconds > 0)
+				{
+					Adapter->ReceiveRate = (Row.InOctets - Adapter->Received) / Seconds;
+					Adapter->SendRate = (Row.OutOctets - Adapter->Sent) / Seconds;
+					Adapter->Received = Row.InOctets;
+					Adapter->Sent = Row.OutOctets;
+				}
+
+				Adapter->bPresent = true;
+			}
+
+			FreeMibTable(Table);
+		}
+
+		// Disconnected or removed adapters disappear from the dashboard
+		Adapters.erase(std::remove_if(Adapters.begin(), Adapters.end(), [](const NetworkAdapter& Adapter) { return !Adapter.bPresent; }), Adapters.end());
+
+		DevicesTime = Now;
+	}
+
+	/// <summary>
+	///		Set status line, e.g. own footprint of the process
+	/// </summary>
+	/// 
+	/// <param name="Text">Text</param>
+	/// <param name="bWarning">Text is red</param>
+	void SetStatus(const std::wstring& Text, bool bWarning)
+	{
+		Status = Text;
+		StatusColor = bWarning ? ScreenBuffer::eRed : ScreenBuffer::eGray;
+	}
+
+	/// <summary>
+	///		Set the latest alert event line, started alerts are red, ended ones are green
+	/// </summary>
+	/// 
+	/// <param name="Alert">Alert event</param>
+	void SetEvent(const AlertEngine::Event& Alert)
+	{
+		Event.assign(Alert.IsStart ? L"Alert started: " : L"Alert ended: ").append(*Alert.Rule).append(Format(L" (value: %g)", Alert.Value));
+		EventColor = Alert.IsStart ? ScreenBuffer::eRed : ScreenBuffer::eGreen;
+	}
+
+	/// <summary>
+	///		Sample CPU and memory load, draw a frame and append changed cells to console output, it's called every DASHBOARD_FRAME_INTERVAL
+	/// </summary>
+	void Draw()
+	{
+		CONSOLE_SCREEN_BUFFER_INFO Info {};
+		MEMORYSTATUSEX Memory {};
+		wchar_t Time[16] {};
+		time_t Now { std::time(nullptr) };
+		float Total {};
+		int Row {};
+
+		if (!Output)
+		{
+			return;
+		}
+
+		// Window size is checked every frame, resized window is drawn again completely
+		if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &Info))
+		{
+			int Columns { Info.srWindow.Right - Info.srWindow.Left + 1 };
+			int Rows { Info.srWindow.Bottom - Info.srWindow.Top + 1 };
+
+			if (Columns != Screen.GetColumns() || Rows != Screen.GetRows())
+			{
+				Screen.Resize(Columns, Rows);
+			}
+		}
+
+		SampleCores();
+
+		Memory.dwLength = sizeof(Memory);
+		GlobalMemoryStatusEx(&Memory);
+
+		// Bottom rows are kept for the alert and status lines
+		int Bottom { Screen.GetRows() - 2 };
+
+		Screen.Clear();
+
+		wcsftime(Time, sizeof(Time) / sizeof(Time[0]), L"%H:%M:%S", std::localtime(&Now));
+		Screen.Text(Screen.Text(0, Row, L"ComStat realtime ", ScreenBuffer::eCyan), Row, Time);
+		Screen.Text(Screen.GetColumns() - 17, Row, L"CTRL + Z to stop", ScreenBuffer::eGray);
+		Row += 2;
+
+		// CPU, cores are placed in as many columns as the window fits
+		for (auto& Load : CoreLoads)
+		{
+			Total += Load;
+		}
+
+		Total = CoreLoads.size() ? Total / CoreLoads.size() : 0;
+
+		Screen.Text(0, Row, L"CPU", ScreenBuffer::eCyan);
+		Screen.Bar(Screen.Text(10, Row, Format(L"%5.1f%% ", Total)), Row, DASHBOARD_BAR_WIDTH, Total);
+		Row++;
+
+		int PerRow { std::max(Screen.GetColumns() / DASHBOARD_CORE_WIDTH, 1) };
+
+		for (size_t i = 0; i < CoreLoads.size(); i++)
+		{
+			int CoreRow { Row + (int)i / PerRow };
+			int Column { (int)(i % PerRow) * DASHBOARD_CORE_WIDTH };
+
+			if (CoreRow < Bottom)
+			{
+				Screen.Bar(Screen.Text(Column, CoreRow, Format(L"  Core %-3zu%5.1f%% ", i, CoreLoads.at(i))), CoreRow, DASHBOARD_BAR_WIDTH, CoreLoads.at(i));
+			}
+		}
+
+		Row += ((int)CoreLoads.size() + PerRow - 1) / PerRow + 1;
+
+		// Memory
+		if (Row < Bottom)
+		{
+			Screen.Text(0, Row, L"Memory", ScreenBuffer::eCyan);
+
+			int Column { Screen.Bar(Screen.Text(10, Row, Format(L"%5.1f%% ", (float)Memory.dwMemoryLoad)), Row, DASHBOARD_BAR_WIDTH, (float)Memory.dwMemoryLoad) };
+
+			Screen.Text(Column, Row, Format(L" %.1f of %.1f GB used", (Memory.ullTotalPhys - Memory.ullAvailPhys) / 1073741824.0, Memory.ullTotalPhys / 1073741824.0));
+		}
+
+		Row += 2;
+
+		// Disks, bar shows used space
+		if (Row < Bottom)
+		{
+			Screen.Text(0, Row++, L"Disk", ScreenBuffer::eCyan);
+		}
+
+		for (auto& Drive : Drives)
+		{
+			if (Row >= Bottom)
+			{
+				break;
+			}
+
+			float Used { Drive.Size > 0 && Drive.FreeSpace >= 0 ? (1 - Drive.FreeSpace / Drive.Size) * 100 : 0 };
+
+			Screen.Text(2, Row, Drive.Letter);
+
+			int Column { Screen.Bar(Screen.Text(10, Row, Format(L"%5.1f%% ", Used)), Row, DASHBOARD_BAR_WIDTH, Used) };
+
+			Screen.Text(Column, Row, Format(L" %.1f of %.1f GB free", std::max(Drive.FreeSpace, 0.0f), Drive.Size));
+			Row++;
+		}
+
+		Row++;
+
+		// Network
+		if (Row < Bottom)
+		{
+			Screen.Text(0, Row++, L"Network", ScreenBuffer::eCyan);
+		}
+
+		for (auto& Adapter : Adapters)
+		{
+			if (Row >= Bottom)
+			{
+				break;
+			}
+
+			Screen.Text(2, Row, std::wstring_view(Adapter.Name).substr(0, DASHBOARD_NAME_WIDTH));
+			Screen.Text(Screen.Text(DASHBOARD_NAME_WIDTH + 4, Row, L"down ", ScreenBuffer::eGray), Row, FormatRate(Adapter.ReceiveRate));
+			Screen.Text(Screen.Text(DASHBOARD_NAME_WIDTH + 22, Row, L"up ", ScreenBuffer::eGray), Row, FormatRate(Adapter.SendRate));
+			Row++;
+		}
+
+		Screen.Text(0, Bottom, Event, EventColor);
+		Screen.Text(0, Bottom + 1, Status, StatusColor);
+
+		Screen.Render(Frame);
+		*Output << Frame;
+		Frame.clear();
+	}
+
+private:
+
+	/// <summary>
+	///		Drive free space
+	/// </summary>
+	struct Drive
+	{
+		std::wstring Letter {};
+		float Size {};
+		float FreeSpace {};
+	};
+
+	/// <summary>
+	///		Network adapter throughput, rates are bytes per second
+	/// </summary>
+	struct NetworkAdapter
+	{
+		ULONG64 Luid {};
+		std::wstring Name {};
+		ULONG64 Received {};
+		ULONG64 Sent {};
+		double ReceiveRate {};
+		double SendRate {};
+		bool bPresent {};
+	};
+
+	/// <summary>
+	///		Sample load of every logical processor since the previous frame, kernel time includes idle time
+	/// </summary>
+	void SampleCores()
+	{
+		ULONG Returned {};
+
+		// NTSTATUS is negative on failure
+		if (Times.empty() || NtQuerySystemInformation(SystemProcessorPerformanceInformation, Times.data(),
+			(ULONG)(Times.size() * sizeof(Times.at(0))), &Returned) < 0)
+		{
+			return;
+		}
+
+		for (size_t i = 0; i < Times.size() && bSampled; i++)
+		{
+			long long Idle { Times.at(i).IdleTime.QuadPart - PreviousTimes.at(i).IdleTime.QuadPart };
+			long long Busy { Times.at(i).KernelTime.QuadPart - PreviousTimes.at(i).KernelTime.QuadPart
+				+ Times.at(i).UserTime.QuadPart - PreviousTimes.at(i).UserTime.QuadPart };
+
+			CoreLoads.at(i) = Busy > 0 ? std::clamp((1.0f - (float)Idle / Busy) * 100, 0.0f, 100.0f) : CoreLoads.at(i);
+		}
+
+		Times.swap(PreviousTimes);
+		bSampled = true;
+	}
+
+	/// <summary>
+	///		Format text into the frame buffer
+	/// </summary>
+	/// 
+	/// <param name="Pattern">swprintf format</param>
+	/// 
+	/// <returns>std::wstring_view, it's valid until the next call</returns>
+	std::wstring_view Format(const wchar_t* Pattern, ...)
+	{
+		va_list Arguments;
+
+		va_start(Arguments, Pattern);
+		int Length { vswprintf(Text, sizeof(Text) / sizeof(Text[0]), Pattern, Arguments) };
+		va_end(Arguments);
+
+		return std::wstring_view(Text, Length > 0 ? Length : 0);
+	}
+
+	/// <summary>
+	///		Format bytes per second
+	/// </summary>
+	/// 
+	/// <param name="Rate">Bytes per second</param>
+	/// 
+	/// <returns>std::wstring_view, it's valid until the next call</returns>
+	std::wstring_view FormatRate(double Rate)
+	{
+		return Rate >= 1048576 ? Format(L"%7.1f MB/s", Rate / 1048576) : Format(L"%7.1f KB/s", Rate / 1024);
+	}
+
+	ScreenBuffer Screen {};
+	ConsoleOutput* Output {};
+	DWORD Mode {};
+	std::wstring Frame {};
+	wchar_t Text[128] {};
+
+	std::vector <SYSTEM_PROCESSOR_PERFORMANCE_INFORMATION> Times {};
+	std::vector <SYSTEM_PROCESSOR_PERFORMANCE_INFORMATION> PreviousTimes {};
+	std::vector <float> CoreLoads {};
+	bool bSampled {};
+
+	std::vector <Drive> Drives {};
+	std::vector <NetworkAdapter> Adapters {};
+	std::chrono::steady_clock::time_point DevicesTime {};
+
+	std::wstring Event {};
+	std::wstring Status {};
+	ScreenBuffer::Colors EventColor { ScreenBuffer::eDefault };
+	ScreenBuffer::Colors StatusColor { ScreenBuffer::eGray };
+};
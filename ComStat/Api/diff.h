@@ -0,0 +1,163 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "../Api/dump.h"
+#include "../Api/fields.h"
+
+/// <summary>
+///		Field by field comparison of two inventory dumps written by "save"
+/// </summary>
+class InventoryDiff
+{
+
+public:
+
+	/// <summary>
+	///		Change kinds enum
+	/// </summary>
+	enum
+	{
+		eChanged,
+		eAdded,
+		eRemoved
+	};
+
+	/// <summary>
+	///		Difference of one record or field, Field is nullptr if the whole record was added or removed
+	/// </summary>
+	struct Change
+	{
+		const Fields::Category* Category {};
+		const Fields::Field* Field {};
+		std::string_view Key {};
+		std::string_view Before {};
+		std::string_view After {};
+		int Kind {};
+	};
+
+	/// <summary>
+	///		Compare dumps, list records are joined by category key through hash table.
+	///		Volatile fields, e.g. free space, differ in almost every dump, so they aren't compared
+	/// </summary>
+	/// 
+	/// <param name="Before">Older dump</param>
+	/// <param name="After">Newer dump</param>
+	/// <param name="Changes">Differences</param>
+	void Compare(const InventoryDump& Before, const InventoryDump& After, std::vector <Change>& Changes)
+	{
+		Changes.clear();
+
+		for (size_t i = 0; i < Fields::Categories.size(); i++)
+		{
+			auto& Category { Fields::Categories.at(i) };
+			auto& BeforeRecords { Before.GetRecords(i) };
+			auto& AfterRecords { After.GetRecords(i) };
+			size_t Key { KeyIndex(Category) };
+
+			// Build side, records with equal keys are chained in dump order
+			Index.clear();
+			Next.assign(BeforeRecords.size(), NONE);
+			bMatched.assign(BeforeRecords.size(), false);
+
+			for (size_t j = BeforeRecords.size(); j-- > 0;)
+			{
+				auto Inserted { Index.try_emplace(RecordKey(BeforeRecords.at(j), Key), j) };
+
+				if (!Inserted.second)
+				{
+					Next.at(j) = Inserted.first->second;
+					Inserted.first->second = j;
+				}
+			}
+
+			// Probe side
+			for (auto& Record : AfterRecords)
+			{
+				std::string_view RecordName { RecordKey(Record, Key) };
+				auto Found { Index.find(RecordName) };
+				size_t Match { Found == Index.end() ? NONE : Found->second };
+
+				while (Match != NONE && bMatched.at(Match))
+				{
+					Match = Next.at(Match);
+				}
+
+				if (Match == NONE)
+				{
+					Changes.push_back({ &Category, nullptr, RecordName, {}, {}, eAdded });
+					continue;
+				}
+
+				bMatched.at(Match) = true;
+
+				for (size_t k = 0; k < Category.Fields.size(); k++)
+				{
+					if (Category.Fields.at(k).IsVolatile)
+					{
+						continue;
+					}
+
+					std::string_view Old { BeforeRecords.at(Match).at(k) };
+					std::string_view New { Record.at(k) };
+
+					if (Old != New)
+					{
+						Changes.push_back({ &Category, &Category.Fields.at(k), RecordName, Old, New, eChanged });
+					}
+				}
+			}
+
+			for (size_t j = 0; j < BeforeRecords.size(); j++)
+			{
+				if (!bMatched.at(j))
+				{
+					Changes.push_back({ &Category, nullptr, RecordKey(BeforeRecords.at(j), Key), {}, {}, eRemoved });
+				}
+			}
+		}
+	}
+
+private:
+
+	static constexpr size_t NONE { (size_t)-1 };
+
+	/// <summary>
+	///		Get index of category key field
+	/// </summary>
+	/// 
+	/// <param name="Category">Category</param>
+	/// 
+	/// <returns>size_t, NONE if records aren't identified by key</returns>
+	static size_t KeyIndex(const Fields::Category& Category)
+	{
+		for (size_t i = 0; i < Category.Fields.size(); i++)
+		{
+			if (Category.Fields.at(i).Name == Category.Key)
+			{
+				return i;
+			}
+		}
+
+		return NONE;
+	}
+
+	/// <summary>
+	///		Get record key value
+	/// </summary>
+	/// 
+	/// <param name="Record">Record values</param>
+	/// <param name="Key">Key field index</param>
+	/// 
+	/// <returns>std::string_view</returns>
+	static std::string_view RecordKey(const std::vector <std::string_view>& Record, size_t Key)
+	{
+		return Key == NONE ? std::string_view {} : Record.at(Key);
+	}
+
+	std::unordered_map <std::string_view, size_t> Index {};
+	std::vector <size_t> Next {};
+	std::vector <bool> bMatched {};
+};
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../Api/compress.h"
+#include "../Api/fields.h"
+
+/// <summary>
+///		Inventory dump written by "save", values point into the dump text
+/// </summary>
+class InventoryDump
+{
+
+public:
+
+	/// <summary>
+	///		Load dump from statistics file
+	/// </summary>
+	/// 
+	/// <param name="Path">Statistics file</param>
+	/// <param name="FromEnd">Dump index counting from the last one, 0 is the last dump</param>
+	/// 
+	/// <returns>bool, false if the file or the dump doesn't exist</returns>
+	bool Load(const std::wstring& Path, size_t FromEnd)
+	{
+		std::ifstream File(std::filesystem::path(Path), std::ios::in | std::ios::binary);
+		std::ostringstream Content {};
+
+		if (!File.is_open())
+		{
+			return false;
+		}
+
+		Content << File.rdbuf();
+		Text = Content.str();
+
+		// Compressed statistics file written with "--compress"
+		if (BlockCompression::IsCompressed(Text))
+		{
+			std::string Raw {};
+
+			if (!BlockCompression::DecompressBlocks(Text, Raw))
+			{
+				return false;
+			}
+
+			Text = std::move(Raw);
+		}
+
+		return Parse(Text, FromEnd);
+	}
+
+	/// <summary>
+	///		Parse dump in place, e.g. in memory-mapped file, the text must outlive the dump
+	/// </summary>
+	/// 
+	/// <param name="Statistics">Statistics file content</param>
+	/// <param name="FromEnd">Dump index counting from the last one, 0 is the last dump</param>
+	/// 
+	/// <returns>bool, false if the dump doesn't exist</returns>
+	bool Parse(std::string_view Statistics, size_t FromEnd)
+	{
+		static const std::string_view Marker { "\nSaved time: " };
+
+		// Dumps are appended, the requested one is found from the end
+		size_t End { std::string_view::npos };
+		size_t Start { Statistics.size() };
+
+		for (size_t i = 0; i <= FromEnd; i++)
+		{
+			if (!Start || (Start = Statistics.rfind(Marker, Start - 1)) == std::string_view::npos)
+			{
+				return false;
+			}
+
+			if (i < FromEnd)
+			{
+				End = Start;
+			}
+		}
+
+		ParseDump(Statistics.substr(Start + 1, End == std::string_view::npos ? End : End - Start - 1));
+
+		return true;
+	}
+
+	/// <summary>
+	///		Get category records
+	/// </summary>
+	/// 
+	/// <param name="Category">Category index</param>
+	/// 
+	/// <returns>const std::vector <std::vector <std::string_view>>&</returns>
+	const std::vector <std::vector <std::string_view>>& GetRecords(size_t Category) const
+	{
+		return Records.at(Category);
+	}
+
+	/// <summary>
+	///		Get time of the dump
+	/// </summary>
+	/// 
+	/// <returns>std::string_view</returns>
+	std::string_view GetTime() const
+	{
+		return Time;
+	}
+
+private:
+
+	/// <summary>
+	///		Compare dump text with wide ASCII name
+	/// </summary>
+	/// 
+	/// <param name="Narrow">Dump text</param>
+	/// <param name="Wide">Name</param>
+	/// 
+	/// <returns>bool</returns>
+	static bool Equals(std::string_view Narrow, const std::wstring& Wide)
+	{
+		if (Narrow.size() != Wide.size())
+		{
+			return false;
+		}
+
+		for (size_t i = 0; i < Narrow.size(); i++)
+		{
+			if ((unsigned char)Narrow[i] != Wide[i])
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/// <summary>
+	///		Split dump into categories and records, records are separated by empty lines
+	/// </summary>
+	/// 
+	/// <param name="Text">Dump text starting with "Saved time: "</param>
+	void ParseDump(std::string_view Text)
+	{
+		std::vector <std::vector <std::string_view>>* CategoryRecords {};
+		const Fields::Category* Category {};
+		bool bRecord {};
+
+		Records.assign(Fields::Categories.size(), {});
+
+		while (!Text.empty())
+		{
+			size_t End { Text.find('\n') };
+			std::string_view Line { Text.substr(0, End) };
+
+			Text.remove_prefix(End == std::string_view::npos ? Text.size() : End + 1);
+
+			if (Line.size() && Line.back() == '\r')
+			{
+				Line.remove_suffix(1);
+			}
+
+			size_t Separator { Line.find(": ") };
+
+			if (Line.empty())
+			{
+				bRecord = false;
+				continue;
+			}
+
+			if (Separator == std::string_view::npos)
+			{
+				// Centered title between dashed lines
+				size_t First { Line.find_first_not_of(' ') };
+				size_t Last { Line.find_last_not_of(' ') };
+
+				for (size_t i = 0; First != std::string_view::npos && i < Fields::Categories.size(); i++)
+				{
+					if (Equals(Line.substr(First, Last - First + 1), Fields::Categories.at(i).Title))
+					{
+						Category = &Fields::Categories.at(i);
+						CategoryRecords = &Records.at(i);
+						bRecord = false;
+					}
+				}
+
+				continue;
+			}
+
+			std::string_view Label { Line.substr(0, Separator) };
+
+			if (!Category)
+			{
+				if (Label == "Saved time")
+				{
+					Time = Line.substr(Separator + 2);
+				}
+
+				continue;
+			}
+
+			for (size_t i = 0; i < Category->Fields.size(); i++)
+			{
+				if (!Equals(Label, Category->Fields.at(i).Label))
+				{
+					continue;
+				}
+
+				// Repeated label starts the next record even without empty line
+				if (!bRecord || CategoryRecords->back().at(i).data())
+				{
+					CategoryRecords->emplace_back(Category->Fields.size());
+					bRecord = true;
+				}
+
+				CategoryRecords->back().at(i) = Line.substr(Separator + 2);
+				break;
+			}
+		}
+	}
+
+	std::string Text {};
+	std::string_view Time {};
+
+	// Records of every category, values in the same order as category fields
+	std::vector <std::vector <std::vector <std::string_view>>> Records {};
+};
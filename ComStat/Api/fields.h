@@ -0,0 +1,331 @@
+#pragma once
+
+#include <algorithm>
+#include <cwchar>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "../Api/comstat.h"
+
+/// <summary>
+///		Inventory fields registry, printing, saving, projection, serialization and loading are generated from it
+/// </summary>
+namespace Fields
+{
+	/// <summary>
+	///		Value formatters enum
+	/// </summary>
+	enum
+	{
+		eText,
+		eInteger,
+		eReal,
+		eYesNo,
+		eMediaType,
+		eResolution
+	};
+
+	/// <summary>
+	///		Field value, strings are referenced, not copied
+	/// </summary>
+	struct Value
+	{
+		Value(const std::wstring& String) : String(&String) {}
+		Value(long long Integer) : Integer(Integer) {}
+		Value(int Integer) : Integer(Integer) {}
+		Value(unsigned int Integer) : Integer(Integer) {}
+		Value(bool Boolean) : Integer(Boolean) {}
+		Value(float Real) : Real(Real) {}
+
+		const std::wstring* String {};
+		long long Integer {};
+		long long Second {};
+		float Real {};
+	};
+
+	/// <summary>
+	///		Field description, volatile values change while the program runs, e.g. free space, so they don't identify the record
+	/// </summary>
+	struct Field
+	{
+		std::wstring Name {};
+		std::wstring Label {};
+		const wchar_t* Unit {};
+		int Format {};
+		Value (*Get)(const void* Record) {};
+		void (*Set)(void* Record, const Value& FieldValue) {};
+		bool IsVolatile {};
+	};
+
+	/// <summary>
+	///		Category description, records are objects of one inventory array or a single object,
+	///		list records are identified by Key field across snapshots
+	/// </summary>
+	struct Category
+	{
+		std::wstring Name {};
+		std::wstring Title {};
+		unsigned int Query {};
+		bool IsList {};
+		size_t (*Count)(const ComputerStatistics& Statistics) {};
+		const void* (*Record)(const ComputerStatistics& Statistics, size_t Index) {};
+		void* (*Insert)(ComputerStatistics& Statistics) {};
+		std::vector <Field> Fields {};
+		std::wstring Key {};
+	};
+
+	/// <summary>
+	///		Member accessor
+	/// </summary>
+	/// 
+	/// <typeparam name="T">Record type</typeparam>
+	/// <typeparam name="Member">Member pointer</typeparam>
+	/// <param name="Record">Record</param>
+	/// 
+	/// <returns>Value</returns>
+	template <typename T, auto Member>
+	Value Get(const void* Record)
+	{
+		return Value(((const T*)Record)->*Member);
+	}
+
+	/// <summary>
+	///		Member mutator
+	/// </summary>
+	/// 
+	/// <typeparam name="T">Record type</typeparam>
+	/// <typeparam name="Member">Member pointer</typeparam>
+	/// <param name="Record">Record</param>
+	/// <param name="FieldValue">Value</param>
+	template <typename T, auto Member>
+	void Set(void* Record, const Value& FieldValue)
+	{
+		auto& Target { ((T*)Record)->*Member };
+
+		if constexpr (std::is_same_v<std::decay_t<decltype(Target)>, std::wstring>)
+		{
+			Target = *FieldValue.String;
+		}
+		else if constexpr (std::is_floating_point_v<std::decay_t<decltype(Target)>>)
+		{
+			Target = FieldValue.Real;
+		}
+		else if constexpr (std::is_same_v<std::decay_t<decltype(Target)>, bool>)
+		{
+			Target = FieldValue.Integer != 0;
+		}
+		else
+		{
+			Target = (std::decay_t<decltype(Target)>)FieldValue.Integer;
+		}
+	}
+
+	/// <summary>
+	///		GPU resolution accessor
+	/// </summary>
+	/// 
+	/// <param name="Record">Record</param>
+	/// 
+	/// <returns>Value</returns>
+	inline Value GetResolution(const void* Record)
+	{
+		Value Resolution { ((const ComputerStatistics::GPUObject*)Record)->XResolution };
+		Resolution.Second = ((const ComputerStatistics::GPUObject*)Record)->YResolution;
+
+		return Resolution;
+	}
+
+	/// <summary>
+	///		GPU resolution mutator
+	/// </summary>
+	/// 
+	/// <param name="Record">Record</param>
+	/// <param name="FieldValue">Value</param>
+	inline void SetResolution(void* Record, const Value& FieldValue)
+	{
+		((ComputerStatistics::GPUObject*)Record)->XResolution = (int)FieldValue.Integer;
+		((ComputerStatistics::GPUObject*)Record)->YResolution = (int)FieldValue.Second;
+	}
+
+	/// <summary>
+	///		Categories in the same order as commands, fields in the same order as sub commands.
+	///		The table is built once at startup, only member accessors are generated at compile time
+	/// </summary>
+	const std::vector <Category> Categories
+	{
+		{
+			L"disk", L"Disks", ComputerStatistics::eQueryDisk, true,
+			[](const ComputerStatistics& Statistics) -> size_t { return Statistics.Disk.size(); },
+			[](const ComputerStatistics& Statistics, size_t Index) -> const void* { return &Statistics.Disk.at(Index); },
+			[](ComputerStatistics& Statistics) -> void* { return &Statistics.Disk.emplace_back(); },
+			{
+				{ L"model", L"Model", L"", eText, &Get<ComputerStatistics::DiskObject, &ComputerStatistics::DiskObject::Model>, &Set<ComputerStatistics::DiskObject, &ComputerStatistics::DiskObject::Model> },
+				{ L"serialnumber", L"Serial Number", L"", eText, &Get<ComputerStatistics::DiskObject, &ComputerStatistics::DiskObject::SerialNumber>, &Set<ComputerStatistics::DiskObject, &ComputerStatistics::DiskObject::SerialNumber> },
+				{ L"interface", L"Interface Type", L"", eText, &Get<ComputerStatistics::DiskObject, &ComputerStatistics::DiskObject::Interface>, &Set<ComputerStatistics::DiskObject, &ComputerStatistics::DiskObject::Interface> },
+				{ L"driveletter", L"Drive Letter", L"", eText, &Get<ComputerStatistics::DiskObject, &ComputerStatistics::DiskObject::DriveLetter>, &Set<ComputerStatistics::DiskObject, &ComputerStatistics::DiskObject::DriveLetter> },
+				{ L"size", L"Size", L" GB", eInteger, &Get<ComputerStatistics::DiskObject, &ComputerStatistics::DiskObject::Size>, &Set<ComputerStatistics::DiskObject, &ComputerStatistics::DiskObject::Size> },
+				{ L"freespace", L"Free Space", L" GB", eInteger, &Get<ComputerStatistics::DiskObject, &ComputerStatistics::DiskObject::FreeSpace>, &Set<ComputerStatistics::DiskObject, &ComputerStatistics::DiskObject::FreeSpace>, true },
+				{ L"mediatype", L"Media Type", L"", eMediaType, &Get<ComputerStatistics::DiskObject, &ComputerStatistics::DiskObject::MediaType>, &Set<ComputerStatistics::DiskObject, &ComputerStatistics::DiskObject::MediaType> },
+				{ L"isbootdrive", L"Boot Drive", L"", eYesNo, &Get<ComputerStatistics::DiskObject, &ComputerStatistics::DiskObject::IsBootDrive>, &Set<ComputerStatistics::DiskObject, &ComputerStatistics::DiskObject::IsBootDrive> }
+			},
+			L"serialnumber"
+		},
+		{
+			L"smbios", L"SMBIOS", ComputerStatistics::eQuerySMBIOS, false,
+			[](const ComputerStatistics&) -> size_t { return 1; },
+			[](const ComputerStatistics& Statistics, size_t) -> const void* { return &Statistics.SMBIOS; },
+			[](ComputerStatistics& Statistics) -> void* { return &Statistics.SMBIOS; },
+			{
+				{ L"manufacturer", L"Manufacturer", L"", eText, &Get<ComputerStatistics::SMBIOSObject, &ComputerStatistics::SMBIOSObject::Manufacturer>, &Set<ComputerStatistics::SMBIOSObject, &ComputerStatistics::SMBIOSObject::Manufacturer> },
+				{ L"product", L"Product", L"", eText, &Get<ComputerStatistics::SMBIOSObject, &ComputerStatistics::SMBIOSObject::Product>, &Set<ComputerStatistics::SMBIOSObject, &ComputerStatistics::SMBIOSObject::Product> },
+				{ L"version", L"Version", L"", eText, &Get<ComputerStatistics::SMBIOSObject, &ComputerStatistics::SMBIOSObject::Version>, &Set<ComputerStatistics::SMBIOSObject, &ComputerStatistics::SMBIOSObject::Version> },
+				{ L"serialnumber", L"Serial Number", L"", eText, &Get<ComputerStatistics::SMBIOSObject, &ComputerStatistics::SMBIOSObject::SerialNumber>, &Set<ComputerStatistics::SMBIOSObject, &ComputerStatistics::SMBIOSObject::SerialNumber> }
+			}
+		},
+		{
+			L"gpu", L"GPUs", ComputerStatistics::eQueryGPU, true,
+			[](const ComputerStatistics& Statistics) -> size_t { return Statistics.GPU.size(); },
+			[](const ComputerStatistics& Statistics, size_t Index) -> const void* { return &Statistics.GPU.at(Index); },
+			[](ComputerStatistics& Statistics) -> void* { return &Statistics.GPU.emplace_back(); },
+			{
+				{ L"name", L"Name", L"", eText, &Get<ComputerStatistics::GPUObject, &ComputerStatistics::GPUObject::Name>, &Set<ComputerStatistics::GPUObject, &ComputerStatistics::GPUObject::Name> },
+				{ L"driverversion", L"Driver Version", L"", eText, &Get<ComputerStatistics::GPUObject, &ComputerStatistics::GPUObject::DriverVersion>, &Set<ComputerStatistics::GPUObject, &ComputerStatistics::GPUObject::DriverVersion> },
+				{ L"resolution", L"Resolution", L"", eResolution, &GetResolution, &SetResolution },
+				{ L"refreshrate", L"Refresh Rate", L"", eInteger, &Get<ComputerStatistics::GPUObject, &ComputerStatistics::GPUObject::RefreshRate>, &Set<ComputerStatistics::GPUObject, &ComputerStatistics::GPUObject::RefreshRate> }
+			},
+			L"name"
+		},
+		{
+			L"cpu", L"CPU", ComputerStatistics::eQueryCPU, false,
+			[](const ComputerStatistics&) -> size_t { return 1; },
+			[](const ComputerStatistics& Statistics, size_t) -> const void* { return &Statistics.CPU; },
+			[](ComputerStatistics& Statistics) -> void* { return &Statistics.CPU; },
+			{
+				{ L"processorid", L"Processor Id", L"", eText, &Get<ComputerStatistics::CPUObject, &ComputerStatistics::CPUObject::ProcessorId>, &Set<ComputerStatistics::CPUObject, &ComputerStatistics::CPUObject::ProcessorId> },
+				{ L"manufacturer", L"Manufacturer", L"", eText, &Get<ComputerStatistics::CPUObject, &ComputerStatistics::CPUObject::Manufacturer>, &Set<ComputerStatistics::CPUObject, &ComputerStatistics::CPUObject::Manufacturer> },
+				{ L"name", L"Name", L"", eText, &Get<ComputerStatistics::CPUObject, &ComputerStatistics::CPUObject::Name>, &Set<ComputerStatistics::CPUObject, &ComputerStatistics::CPUObject::Name> },
+				{ L"cores", L"Cores", L"", eInteger, &Get<ComputerStatistics::CPUObject, &ComputerStatistics::CPUObject::Cores>, &Set<ComputerStatistics::CPUObject, &ComputerStatistics::CPUObject::Cores> },
+				{ L"threads", L"Threads", L"", eInteger, &Get<ComputerStatistics::CPUObject, &ComputerStatistics::CPUObject::Threads>, &Set<ComputerStatistics::CPUObject, &ComputerStatistics::CPUObject::Threads> }
+			}
+		},
+		{
+			L"network", L"Network", ComputerStatistics::eQueryNetwork, true,
+			[](const ComputerStatistics& Statistics) -> size_t { return Statistics.NetworkAdapter.size(); },
+			[](const ComputerStatistics& Statistics, size_t Index) -> const void* { return &Statistics.NetworkAdapter.at(Index); },
+			[](ComputerStatistics& Statistics) -> void* { return &Statistics.NetworkAdapter.emplace_back(); },
+			{
+				{ L"name", L"Name", L"", eText, &Get<ComputerStatistics::NetworkAdapterObject, &ComputerStatistics::NetworkAdapterObject::Name>, &Set<ComputerStatistics::NetworkAdapterObject, &ComputerStatistics::NetworkAdapterObject::Name> },
+				{ L"mac", L"MAC Address", L"", eText, &Get<ComputerStatistics::NetworkAdapterObject, &ComputerStatistics::NetworkAdapterObject::MAC>, &Set<ComputerStatistics::NetworkAdapterObject, &ComputerStatistics::NetworkAdapterObject::MAC> }
+			},
+			L"mac"
+		},
+		{
+			L"system", L"System", ComputerStatistics::eQuerySystem, false,
+			[](const ComputerStatistics&) -> size_t { return 1; },
+			[](const ComputerStatistics& Statistics, size_t) -> const void* { return &Statistics.System; },
+			[](ComputerStatistics& Statistics) -> void* { return &Statistics.System; },
+			{
+				{ L"name", L"System Name", L"", eText, &Get<ComputerStatistics::SystemObject, &ComputerStatistics::SystemObject::Name>, &Set<ComputerStatistics::SystemObject, &ComputerStatistics::SystemObject::Name> },
+				{ L"ishypervisorpresent", L"Hypervisor Present", L"", eYesNo, &Get<ComputerStatistics::SystemObject, &ComputerStatistics::SystemObject::IsHypervisorPresent>, &Set<ComputerStatistics::SystemObject, &ComputerStatistics::SystemObject::IsHypervisorPresent> },
+				{ L"osversion", L"OS Version", L"", eText, &Get<ComputerStatistics::SystemObject, &ComputerStatistics::SystemObject::OSVersion>, &Set<ComputerStatistics::SystemObject, &ComputerStatistics::SystemObject::OSVersion> },
+				{ L"ostitle", L"OS Title", L"", eText, &Get<ComputerStatistics::SystemObject, &ComputerStatistics::SystemObject::OSName>, &Set<ComputerStatistics::SystemObject, &ComputerStatistics::SystemObject::OSName> },
+				{ L"osarchitecture", L"OS Architecture", L"", eText, &Get<ComputerStatistics::SystemObject, &ComputerStatistics::SystemObject::OSArchitecture>, &Set<ComputerStatistics::SystemObject, &ComputerStatistics::SystemObject::OSArchitecture> },
+				{ L"osserialnumber", L"OS Serial Number", L"", eText, &Get<ComputerStatistics::SystemObject, &ComputerStatistics::SystemObject::OSSerialNumber>, &Set<ComputerStatistics::SystemObject, &ComputerStatistics::SystemObject::OSSerialNumber> }
+			}
+		},
+		{
+			L"physicalmemory", L"Memory", ComputerStatistics::eQueryPhysicalMemory, false,
+			[](const ComputerStatistics&) -> size_t { return 1; },
+			[](const ComputerStatistics& Statistics, size_t) -> const void* { return &Statistics.PhysicalMemory; },
+			[](ComputerStatistics& Statistics) -> void* { return &Statistics.PhysicalMemory; },
+			{
+				{ L"partnumber", L"Part Number", L"", eText, &Get<ComputerStatistics::PhysicalMemoryObject, &ComputerStatistics::PhysicalMemoryObject::PartNumber>, &Set<ComputerStatistics::PhysicalMemoryObject, &ComputerStatistics::PhysicalMemoryObject::PartNumber> },
+				{ L"totalsize", L"Total Physical Size", L" MB", eReal, &Get<ComputerStatistics::PhysicalMemoryObject, &ComputerStatistics::PhysicalMemoryObject::TotalSize>, &Set<ComputerStatistics::PhysicalMemoryObject, &ComputerStatistics::PhysicalMemoryObject::TotalSize> },
+				{ L"availablesize", L"Available Physical Size", L" MB", eReal, &Get<ComputerStatistics::PhysicalMemoryObject, &ComputerStatistics::PhysicalMemoryObject::AvailableSize>, &Set<ComputerStatistics::PhysicalMemoryObject, &ComputerStatistics::PhysicalMemoryObject::AvailableSize>, true },
+				{ L"totalvirtualsize", L"Total Virtual Size", L" MB", eReal, &Get<ComputerStatistics::PhysicalMemoryObject, &ComputerStatistics::PhysicalMemoryObject::TotalVirtualSize>, &Set<ComputerStatistics::PhysicalMemoryObject, &ComputerStatistics::PhysicalMemoryObject::TotalVirtualSize> },
+				{ L"availablevirtualsize", L"Available Virtual Size", L" MB", eReal, &Get<ComputerStatistics::PhysicalMemoryObject, &ComputerStatistics::PhysicalMemoryObject::AvailableVirtualSize>, &Set<ComputerStatistics::PhysicalMemoryObject, &ComputerStatistics::PhysicalMemoryObject::AvailableVirtualSize>, true },
+				{ L"totalpagefilesize", L"Total Page File Size", L" MB", eReal, &Get<ComputerStatistics::PhysicalMemoryObject, &ComputerStatistics::PhysicalMemoryObject::TotalPageSize>, &Set<ComputerStatistics::PhysicalMemoryObject, &ComputerStatistics::PhysicalMemoryObject::TotalPageSize> },
+				{ L"availablepagefilesize", L"Available Page File Size", L" MB", eReal, &Get<ComputerStatistics::PhysicalMemoryObject, &ComputerStatistics::PhysicalMemoryObject::AvailablePageSize>, &Set<ComputerStatistics::PhysicalMemoryObject, &ComputerStatistics::PhysicalMemoryObject::AvailablePageSize>, true }
+			}
+		},
+		{
+			L"registry", L"Registry", ComputerStatistics::eQueryRegistry, false,
+			[](const ComputerStatistics&) -> size_t { return 1; },
+			[](const ComputerStatistics& Statistics, size_t) -> const void* { return &Statistics.Registry; },
+			[](ComputerStatistics& Statistics) -> void* { return &Statistics.Registry; },
+			{
+				{ L"computerhardwareid", L"Computer Hardware Id", L"", eText, &Get<ComputerStatistics::RegistryObject, &ComputerStatistics::RegistryObject::ComputerHardwareId>, &Set<ComputerStatistics::RegistryObject, &ComputerStatistics::RegistryObject::ComputerHardwareId> },
+				{ L"computermanufacturer", L"Computer Manufacturer", L"", eText, &Get<ComputerStatistics::RegistryObject, &ComputerStatistics::RegistryObject::ComputerManufacturer>, &Set<ComputerStatistics::RegistryObject, &ComputerStatistics::RegistryObject::ComputerManufacturer> },
+				{ L"computerproductname", L"Computer Product Name", L"", eText, &Get<ComputerStatistics::RegistryObject, &ComputerStatistics::RegistryObject::ComputerName>, &Set<ComputerStatistics::RegistryObject, &ComputerStatistics::RegistryObject::ComputerName> }
+			}
+		}
+	};
+
+	/// <summary>
+	///		Append field value as text
+	/// </summary>
+	/// 
+	/// <param name="Descriptor">Field</param>
+	/// <param name="FieldValue">Value</param>
+	/// <param name="Output">Output string</param>
+	inline void Format(const Field& Descriptor, const Value& FieldValue, std::wstring& Output)
+	{
+		wchar_t Number[32] {};
+		int Length {};
+
+		switch (Descriptor.Format)
+		{
+		case eText:
+		{
+			Output.append(*FieldValue.String);
+		} break;
+
+		case eInteger:
+		{
+			Length = swprintf(Number, sizeof(Number) / sizeof(Number[0]), L"%lld", FieldValue.Integer);
+		} break;
+
+		case eReal:
+		{
+			Length = swprintf(Number, sizeof(Number) / sizeof(Number[0]), L"%g", FieldValue.Real);
+		} break;
+
+		case eYesNo:
+		{
+			Output.append(FieldValue.Integer ? L"Yes" : L"No");
+		} break;
+
+		case eMediaType:
+		{
+			Output.append(FieldValue.Integer == 4 ? L"SSD" : (FieldValue.Integer == 3 ? L"HDD" : L""));
+		} break;
+
+		case eResolution:
+		{
+			Length = swprintf(Number, sizeof(Number) / sizeof(Number[0]), L"%lldx%lld", FieldValue.Integer, FieldValue.Second);
+		} break;
+		}
+
+		Output.append(Number, Length > 0 ? Length : 0);
+		Output.append(Descriptor.Unit);
+	}
+
+	/// <summary>
+	///		Get column of values for "Label:" rows aligned with tabs, at least three tabs wide
+	/// </summary>
+	/// 
+	/// <param name="Descriptor">Category</param>
+	/// 
+	/// <returns>size_t</returns>
+	inline size_t LabelColumn(const Category& Descriptor)
+	{
+		size_t Column { 24 };
+
+		for (auto& Field : Descriptor.Fields)
+		{
+			Column = std::max(Column, ((Field.Label.size() + 1) / 8 + 1) * 8);
+		}
+
+		return Column;
+	}
+};
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <windows.h>
+#include <dbt.h>
+#include "../Api/comstat.h"
+
+#define HOTPLUG_WINDOW_CLASS L"ComStatDeviceWatcher"
+
+/// <summary>
+///		Watches device interface arrival and removal (WM_DEVICECHANGE) and marks inventory categories they affect as stale,
+///		so only these categories are collected again. The watcher thread sleeps in GetMessage between notifications
+/// </summary>
+class DeviceWatcher
+{
+
+public:
+
+	/// <summary>
+	///		Destructor
+	/// </summary>
+	~DeviceWatcher()
+	{
+		Stop();
+	}
+
+	/// <summary>
+	///		Start watching, changes are reported from now, so it's started before the inventory is collected
+	/// </summary>
+	/// 
+	/// <returns>bool</returns>
+	bool Start()
+	{
+		std::unique_lock <std::mutex> Lock(Mutex);
+
+		if (Worker.joinable())
+		{
+			return true;
+		}
+
+		bReady = false;
+		Worker = std::thread(&DeviceWatcher::Watch, this);
+
+		// Window is created by the watcher thread, its messages are dispatched there
+		Ready.wait(Lock, [this]() { return bReady; });
+
+		if (!Window)
+		{
+			Lock.unlock();
+			Worker.join();
+
+			return false;
+		}
+
+		return true;
+	}
+
+	/// <summary>
+	///		Stop watching
+	/// </summary>
+	void Stop()
+	{
+		if (!Worker.joinable())
+		{
+			return;
+		}
+
+		PostMessageW(Window, WM_CLOSE, 0, 0);
+		Worker.join();
+	}
+
+	/// <summary>
+	///		Get and reset categories changed since the previous call
+	/// </summary>
+	/// 
+	/// <returns>unsigned int, ComputerStatistics categories flags</returns>
+	unsigned int Take()
+	{
+		return Changed.exchange(ComputerStatistics::eQueryNone, std::memory_order_acq_rel);
+	}
+
+private:
+
+	/// <summary>
+	///		Device interface class and the category it belongs to
+	/// </summary>
+	struct InterfaceClass
+	{
+		GUID Class {};
+		unsigned int Category {};
+	};
+
+	/// <summary>
+	///		Get categories affected by device interface class
+	/// </summary>
+	/// 
+	/// <param name="Interface">Device interface notification</param>
+	/// 
+	/// <returns>unsigned int</returns>
+	static unsigned int GetCategory(const DEV_BROADCAST_DEVICEINTERFACE_W* Interface)
+	{
+		// GUID_DEVINTERFACE_DISK, GUID_DEVINTERFACE_VOLUME, GUID_DEVINTERFACE_NET and GUID_DEVINTERFACE_DISPLAY_ADAPTER
+		static const InterfaceClass Classes[]
+		{
+			{ { 0x53f56307, 0xb6bf, 0x11d0, { 0x94, 0xf2, 0x00, 0xa0, 0xc9, 0x1e, 0xfb, 0x8b } }, ComputerStatistics::eQueryDisk },
+			{ { 0x53f5630d, 0xb6bf, 0x11d0, { 0x94, 0xf2, 0x00, 0xa0, 0xc9, 0x1e, 0xfb, 0x8b } }, ComputerStatistics::eQueryDisk },
+			{ { 0xcac88484, 0x7515, 0x4c03, { 0x82, 0xe6, 0x71, 0xa8, 0x7a, 0xba, 0xc3, 0x61 } }, ComputerStatistics::eQueryNetwork },
+			{ { 0x5b45201d, 0xf2f2, 0x4f3b, { 0x85, 0xbb, 0x30, 0xff, 0x1f, 0x95, 0x35, 0x99 } }, ComputerStatistics::eQueryGPU }
+		};
+
+		for (auto& Interfaces : Classes)
+		{
+			if (!memcmp(&Interface->dbcc_classguid, &Interfaces.Class, sizeof(GUID)))
+			{
+				return Interfaces.Category;
+			}
+		}
+
+		return ComputerStatistics::eQueryNone;
+	}
+
+	/// <summary>
+	///		Window procedure of the watcher window
+	/// </summary>
+	/// 
+	/// <param name="hWnd">Window</param>
+	/// <param name="Message">Message</param>
+	/// <param name="wParam">Event</param>
+	/// <param name="lParam">Event data</param>
+	/// 
+	/// <returns>LRESULT</returns>
+	static LRESULT CALLBACK WindowProcedure(HWND hWnd, UINT Message, WPARAM wParam, LPARAM lParam)
+	{
+		if (Message == WM_DEVICECHANGE && (wParam == DBT_DEVICEARRIVAL || wParam == DBT_DEVICEREMOVECOMPLETE) && lParam
+			&& ((DEV_BROADCAST_HDR*)lParam)->dbch_devicetype == DBT_DEVTYP_DEVICEINTERFACE)
+		{
+			auto Watcher { (DeviceWatcher*)GetWindowLongPtrW(hWnd, GWLP_USERDATA) };
+
+			if (Watcher)
+			{
+				Watcher->Changed.fetch_or(GetCategory((DEV_BROADCAST_DEVICEINTERFACE_W*)lParam), std::memory_order_acq_rel);
+			}
+
+			return TRUE;
+		}
+
+		if (Message == WM_DESTROY)
+		{
+			PostQuitMessage(0);
+			return 0;
+		}
+
+		return DefWindowProcW(hWnd, Message, wParam, lParam);
+	}
+
+	/// <summary>
+	///		Watcher thread, message-only window receives notifications of all device interface classes
+	/// </summary>
+	void Watch()
+	{
+		WNDCLASSEXW Class {};
+		DEV_BROADCAST_DEVICEINTERFACE_W Filter {};
+		HDEVNOTIFY Notification {};
+		MSG Message {};
+
+		Class.cbSize = sizeof(Class);
+		Class.lpfnWndProc = WindowProcedure;
+		Class.hInstance = GetModuleHandleW(nullptr);
+		Class.lpszClassName = HOTPLUG_WINDOW_CLASS;
+
+		// Class stays registered if the watcher is started again
+		RegisterClassExW(&Class);
+
+		HWND Handle { CreateWindowExW(0, HOTPLUG_WINDOW_CLASS, L"", 0, 0, 0, 0, 0, HWND_MESSAGE, nullptr, Class.hInstance, nullptr) };
+
+		if (Handle)
+		{
+			SetWindowLongPtrW(Handle, GWLP_USERDATA, (LONG_PTR)this);
+
+			Filter.dbcc_size = sizeof(Filter);
+			Filter.dbcc_devicetype = DBT_DEVTYP_DEVICEINTERFACE;
+			Notification = RegisterDeviceNotificationW(Handle, &Filter, DEVICE_NOTIFY_WINDOW_HANDLE | DEVICE_NOTIFY_ALL_INTERFACE_CLASSES);
+
+			if (!Notification)
+			{
+				DestroyWindow(Handle);
+				Handle = nullptr;
+			}
+		}
+
+		{
+			std::lock_guard <std::mutex> Lock(Mutex);
+
+			Window = Handle;
+			bReady = true;
+		}
+
+		Ready.notify_one();
+
+		if (!Handle)
+		{
+			return;
+		}
+
+		while (GetMessageW(&Message, nullptr, 0, 0) > 0)
+		{
+			TranslateMessage(&Message);
+			DispatchMessageW(&Message);
+		}
+
+		UnregisterDeviceNotification(Notification);
+		Window = nullptr;
+	}
+
+	std::atomic <unsigned int> Changed {};
+	std::thread Worker {};
+	std::mutex Mutex {};
+	std::condition_variable Ready {};
+	HWND Window {};
+	bool bReady {};
+};
@@ -0,0 +1,316 @@
+#pragma once
+
+#include <cstring>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "../Api/fields.h"
+
+/// <summary>
+///		Pool of immutable strings, equal strings share one copy and one id, id 0 is the empty string
+/// </summary>
+/// 
+/// <typeparam name="Char">Character type</typeparam>
+template <typename Char>
+class StringPool
+{
+
+public:
+
+	/// <summary>
+	///		Constructor
+	/// </summary>
+	StringPool()
+	{
+		Intern({});
+	}
+
+	/// <summary>
+	///		Get id of string, the string is copied only the first time
+	/// </summary>
+	/// 
+	/// <param name="String">String</param>
+	/// 
+	/// <returns>unsigned int</returns>
+	unsigned int Intern(std::basic_string_view <Char> String)
+	{
+		auto Found { Index.find(String) };
+
+		if (Found != Index.end())
+		{
+			return Found->second;
+		}
+
+		// Deque doesn't move stored strings, so index keys stay valid
+		auto& Stored { Strings.emplace_back(String) };
+
+		Bytes += (Stored.size() + 1) * sizeof(Char);
+		Index.emplace(Stored, (unsigned int)(Strings.size() - 1));
+
+		return (unsigned int)(Strings.size() - 1);
+	}
+
+	/// <summary>
+	///		Get string by id
+	/// </summary>
+	/// 
+	/// <param name="Id">String id</param>
+	/// 
+	/// <returns>const std::basic_string <Char>&</returns>
+	const std::basic_string <Char>& Get(unsigned int Id) const
+	{
+		return Strings.at(Id);
+	}
+
+	/// <summary>
+	///		Get number of unique strings
+	/// </summary>
+	/// 
+	/// <returns>size_t</returns>
+	size_t Count() const
+	{
+		return Strings.size();
+	}
+
+	/// <summary>
+	///		Get size of unique strings characters
+	/// </summary>
+	/// 
+	/// <returns>size_t</returns>
+	size_t GetBytes() const
+	{
+		return Bytes;
+	}
+
+private:
+
+	std::deque <std::basic_string <Char>> Strings {};
+	std::unordered_map <std::basic_string_view <Char>, unsigned int> Index {};
+	size_t Bytes {};
+};
+
+/// <summary>
+///		Inventory snapshot for multi-snapshot workloads, every field is one 8-byte cell.
+///		Text is a pool id, so snapshots sharing a pool keep one copy of repeated values and equal fields compare as integers
+/// </summary>
+class InternedSnapshot
+{
+
+public:
+
+	/// <summary>
+	///		Constructor
+	/// </summary>
+	/// 
+	/// <param name="Statistics">Inventory</param>
+	/// <param name="Pool">Pool, it must outlive the snapshot</param>
+	InternedSnapshot(const ComputerStatistics& Statistics, StringPool <wchar_t>& Pool) : Pool(&Pool)
+	{
+		Cells.resize(Fields::Categories.size());
+
+		for (size_t i = 0; i < Fields::Categories.size(); i++)
+		{
+			auto& Category { Fields::Categories.at(i) };
+			size_t Count { Category.Count(Statistics) };
+
+			Cells.at(i).reserve(Count * Category.Fields.size());
+
+			for (size_t j = 0; j < Count; j++)
+			{
+				const void* Record { Category.Record(Statistics, j) };
+
+				for (auto& Field : Category.Fields)
+				{
+					Cells.at(i).push_back(Pack(Field, Field.Get(Record)));
+				}
+			}
+		}
+	}
+
+	/// <summary>
+	///		Get number of category records
+	/// </summary>
+	/// 
+	/// <param name="Category">Category index</param>
+	/// 
+	/// <returns>size_t</returns>
+	size_t Count(size_t Category) const
+	{
+		return Cells.at(Category).size() / Fields::Categories.at(Category).Fields.size();
+	}
+
+	/// <summary>
+	///		Get field cell, equal values have equal cells in snapshots of one pool
+	/// </summary>
+	/// 
+	/// <param name="Category">Category index</param>
+	/// <param name="Record">Record index</param>
+	/// <param name="Field">Field index</param>
+	/// 
+	/// <returns>unsigned long long</returns>
+	unsigned long long GetCell(size_t Category, size_t Record, size_t Field) const
+	{
+		return Cells.at(Category).at(Record * Fields::Categories.at(Category).Fields.size() + Field);
+	}
+
+	/// <summary>
+	///		Get text field
+	/// </summary>
+	/// 
+	/// <param name="Category">Category index</param>
+	/// <param name="Record">Record index</param>
+	/// <param name="Field">Field index</param>
+	/// 
+	/// <returns>const std::wstring&</returns>
+	const std::wstring& GetText(size_t Category, size_t Record, size_t Field) const
+	{
+		return Pool->Get((unsigned int)GetCell(Category, Record, Field));
+	}
+
+	/// <summary>
+	///		Get field value
+	/// </summary>
+	/// 
+	/// <param name="Category">Category index</param>
+	/// <param name="Record">Record index</param>
+	/// <param name="Field">Field index</param>
+	/// 
+	/// <returns>Fields::Value, text is referenced from the pool</returns>
+	Fields::Value GetValue(size_t Category, size_t Record, size_t Field) const
+	{
+		unsigned long long Cell { GetCell(Category, Record, Field) };
+
+		switch (Fields::Categories.at(Category).Fields.at(Field).Format)
+		{
+		case Fields::eText:
+		{
+			return Fields::Value(Pool->Get((unsigned int)Cell));
+		}
+
+		case Fields::eReal:
+		{
+			float Real {};
+			unsigned int Bits { (unsigned int)Cell };
+
+			memcpy(&Real, &Bits, sizeof(Real));
+
+			return Fields::Value(Real);
+		}
+
+		case Fields::eResolution:
+		{
+			Fields::Value Resolution { (long long)(int)(Cell >> 32) };
+
+			Resolution.Second = (int)(unsigned int)Cell;
+
+			return Resolution;
+		}
+
+		default:
+		{
+			return Fields::Value((long long)Cell);
+		}
+		}
+	}
+
+	/// <summary>
+	///		Compare inventory with snapshot of the same pool, every field is one integer compare.
+	///		Volatile fields, e.g. free space, differ in almost every snapshot, so they aren't compared
+	/// </summary>
+	/// 
+	/// <param name="Other">Snapshot</param>
+	/// 
+	/// <returns>bool</returns>
+	bool IsSameInventory(const InternedSnapshot& Other) const
+	{
+		for (size_t i = 0; i < Fields::Categories.size(); i++)
+		{
+			auto& Category { Fields::Categories.at(i) };
+			auto& Record { Cells.at(i) };
+			auto& OtherRecord { Other.Cells.at(i) };
+
+			if (Record.size() != OtherRecord.size())
+			{
+				return false;
+			}
+
+			for (size_t j = 0; j < Record.size(); j++)
+			{
+				if (Record.at(j) != OtherRecord.at(j) && !Category.Fields.at(j % Category.Fields.size()).IsVolatile)
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	/// <summary>
+	///		Copy snapshot into inventory, records are appended to list categories
+	/// </summary>
+	/// 
+	/// <param name="Statistics">Inventory</param>
+	void Load(ComputerStatistics& Statistics) const
+	{
+		for (size_t i = 0; i < Fields::Categories.size(); i++)
+		{
+			auto& Category { Fields::Categories.at(i) };
+
+			for (size_t j = 0; j < Count(i); j++)
+			{
+				void* Record { Category.Insert(Statistics) };
+
+				for (size_t k = 0; k < Category.Fields.size(); k++)
+				{
+					Category.Fields.at(k).Set(Record, GetValue(i, j, k));
+				}
+			}
+		}
+	}
+
+private:
+
+	/// <summary>
+	///		Convert field value to cell
+	/// </summary>
+	/// 
+	/// <param name="Field">Field</param>
+	/// <param name="FieldValue">Value</param>
+	/// 
+	/// <returns>unsigned long long</returns>
+	unsigned long long Pack(const Fields::Field& Field, const Fields::Value& FieldValue)
+	{
+		switch (Field.Format)
+		{
+		case Fields::eText:
+		{
+			return Pool->Intern(*FieldValue.String);
+		}
+
+		case Fields::eReal:
+		{
+			unsigned int Bits {};
+
+			memcpy(&Bits, &FieldValue.Real, sizeof(Bits));
+
+			return Bits;
+		}
+
+		case Fields::eResolution:
+		{
+			return (unsigned long long)(unsigned int)FieldValue.Integer << 32 | (unsigned int)FieldValue.Second;
+		}
+
+		default:
+		{
+			return (unsigned long long)FieldValue.Integer;
+		}
+		}
+	}
+
+	std::vector <std::vector <unsigned long long>> Cells {};
+	StringPool <wchar_t>* Pool {};
+};
@@ -0,0 +1,291 @@
+#pragma once
+#pragma comment(lib, "Ws2_32.lib")
+
+#include <winsock2.h>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "../Api/fields.h"
+#include "../Api/serializer.h"
+
+/// <summary>
+///		Loopback HTTP endpoint serving metrics in Prometheus text format from pre-rendered buffer
+/// </summary>
+class MetricsServer
+{
+
+public:
+
+	/// <summary>
+	///		Destructor
+	/// </summary>
+	~MetricsServer()
+	{
+		Stop();
+	}
+
+	/// <summary>
+	///		Start listening on 127.0.0.1
+	/// </summary>
+	/// 
+	/// <param name="Port">Port</param>
+	/// 
+	/// <returns>bool</returns>
+	bool Start(unsigned short Port)
+	{
+		WSADATA Data {};
+		sockaddr_in Address {};
+
+		if (WSAStartup(MAKEWORD(2, 2), &Data))
+		{
+			return false;
+		}
+
+		bStarted = true;
+
+		Address.sin_family = AF_INET;
+		Address.sin_port = htons(Port);
+		Address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+		Listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+
+		if (Listener == INVALID_SOCKET
+			|| bind(Listener, (sockaddr*)&Address, sizeof(Address)) == SOCKET_ERROR
+			|| listen(Listener, SOMAXCONN) == SOCKET_ERROR)
+		{
+			Stop();
+			return false;
+		}
+
+		Worker = std::thread(&MetricsServer::Serve, this);
+
+		return true;
+	}
+
+	/// <summary>
+	///		Stop listening, closing the socket ends accept loop
+	/// </summary>
+	void Stop()
+	{
+		if (Listener != INVALID_SOCKET)
+		{
+			closesocket(Listener);
+			Listener = INVALID_SOCKET;
+		}
+
+		if (Worker.joinable())
+		{
+			Worker.join();
+		}
+
+		if (bStarted)
+		{
+			WSACleanup();
+			bStarted = false;
+		}
+	}
+
+	/// <summary>
+	///		Render inventory as info metrics, e.g. comstat_disk_info{model="...",size="500 GB"} 1.
+	///		Volatile fields aren't labels, every new value would start a new series, they are served as gauges
+	/// </summary>
+	/// 
+	/// <param name="Statistics">Inventory</param>
+	void SetInventory(const ComputerStatistics& Statistics)
+	{
+		std::wstring Value {};
+
+		Inventory.clear();
+
+		for (auto& Category : Fields::Categories)
+		{
+			std::string Name { "comstat_" };
+			Serializer::AppendUTF8(Name, Category.Name);
+			Name.append("_info");
+
+			Inventory.append("# HELP ").append(Name).append(" Inventory information.\n");
+			Inventory.append("# TYPE ").append(Name).append(" gauge\n");
+
+			for (size_t i = 0; i < Category.Count(Statistics); i++)
+			{
+				const void* Record { Category.Record(Statistics, i) };
+
+				char Separator { '{' };
+
+				Inventory.append(Name);
+
+				for (auto& Field : Category.Fields)
+				{
+					if (Field.IsVolatile)
+					{
+						continue;
+					}
+
+					Value.clear();
+					Fields::Format(Field, Field.Get(Record), Value);
+
+					Inventory.push_back(Separator);
+					Separator = ',';
+					Serializer::AppendUTF8(Inventory, Field.Name);
+					Inventory.append("=\"");
+					AppendLabelValue(Inventory, Value);
+					Inventory.push_back('"');
+				}
+
+				Inventory.append("} 1\n");
+			}
+		}
+	}
+
+	/// <summary>
+	///		Start rendering a new sample, inventory goes first
+	/// </summary>
+	void BeginSample()
+	{
+		Sample.assign(Inventory);
+		LastGauge = nullptr;
+	}
+
+	/// <summary>
+	///		Append gauge sample
+	/// </summary>
+	/// 
+	/// <param name="Name">Metric name</param>
+	/// <param name="Help">Metric description</param>
+	/// <param name="Value">Value</param>
+	/// <param name="LabelName">Label name, nullptr if there is no label</param>
+	/// <param name="LabelValue">Label value</param>
+	void AddGauge(const char* Name, const char* Help, double Value, const char* LabelName = nullptr, const std::wstring& LabelValue = {})
+	{
+		char Number[32] {};
+		int Length { snprintf(Number, sizeof(Number), "%g", Value) };
+
+		// Samples of one metric share the header
+		if (!LastGauge || strcmp(LastGauge, Name))
+		{
+			Sample.append("# HELP ").append(Name).append(" ").append(Help).append("\n");
+			Sample.append("# TYPE ").append(Name).append(" gauge\n");
+			LastGauge = Name;
+		}
+
+		Sample.append(Name);
+
+		if (LabelName)
+		{
+			Sample.append("{").append(LabelName).append("=\"");
+			AppendLabelValue(Sample, LabelValue);
+			Sample.append("\"}");
+		}
+
+		Sample.push_back(' ');
+		Sample.append(Number, Length > 0 ? Length : 0);
+		Sample.push_back('\n');
+	}
+
+	/// <summary>
+	///		Publish rendered sample, scrapes served after this call get it
+	/// </summary>
+	void PublishSample()
+	{
+		auto Response { std::make_shared<std::string>() };
+
+		Response->append("HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\nContent-Length: ");
+		Response->append(std::to_string(Sample.size()));
+		Response->append("\r\nConnection: close\r\n\r\n");
+		Response->append(Sample);
+
+		std::lock_guard <std::mutex> Lock(Mutex);
+		Published = std::move(Response);
+	}
+
+private:
+
+	/// <summary>
+	///		Append label value escaped by exposition format rules
+	/// </summary>
+	/// 
+	/// <param name="Output">Output buffer</param>
+	/// <param name="Value">Label value</param>
+	static void AppendLabelValue(std::string& Output, const std::wstring& Value)
+	{
+		size_t Start { Output.size() };
+
+		Serializer::AppendUTF8(Output, Value);
+
+		for (size_t i = Start; i < Output.size(); i++)
+		{
+			if (Output[i] == '\\' || Output[i] == '"')
+			{
+				Output.insert(i++, 1, '\\');
+			}
+			else if (Output[i] == '\n')
+			{
+				Output.replace(i++, 1, "\\n");
+			}
+		}
+	}
+
+	/// <summary>
+	///		Accept loop, every connection gets one response and is closed
+	/// </summary>
+	void Serve()
+	{
+		static const std::string NotFound { "HTTP/1.1 404 Not Found\r\nContent-Type: text/plain\r\nContent-Length: 10\r\nConnection: close\r\n\r\nNot found\n" };
+		char Request[4096] {};
+		SOCKET Server { Listener };
+		DWORD Timeout { 2000 };
+
+		for (SOCKET Client; (Client = accept(Server, nullptr, nullptr)) != INVALID_SOCKET; closesocket(Client))
+		{
+			int Received {};
+			int Length {};
+
+			// Slow client can't block other scrapes for long
+			setsockopt(Client, SOL_SOCKET, SO_RCVTIMEO, (const char*)&Timeout, sizeof(Timeout));
+
+			// Request line and headers, body is ignored
+			while (Length < sizeof(Request) - 1 && (Received = recv(Client, Request + Length, sizeof(Request) - 1 - Length, 0)) > 0)
+			{
+				Length += Received;
+				Request[Length] = '\0';
+
+				if (strstr(Request, "\r\n\r\n"))
+				{
+					break;
+				}
+			}
+
+			std::shared_ptr <const std::string> Response {};
+
+			if (!strncmp(Request, "GET /metrics ", 13) || !strncmp(Request, "GET / ", 6))
+			{
+				std::lock_guard <std::mutex> Lock(Mutex);
+				Response = Published;
+			}
+
+			const std::string& Body { Response ? *Response : NotFound };
+
+			for (int Sent = 0, Result = 0; Sent < Body.size(); Sent += Result)
+			{
+				if ((Result = send(Client, Body.data() + Sent, (int)(Body.size() - Sent), 0)) <= 0)
+				{
+					break;
+				}
+			}
+
+			Request[0] = '\0';
+		}
+	}
+
+	std::string Inventory {};
+	std::string Sample {};
+	std::shared_ptr <const std::string> Published {};
+	std::mutex Mutex {};
+	std::thread Worker {};
+	SOCKET Listener { INVALID_SOCKET };
+	const char* LastGauge {};
+	bool bStarted {};
+};
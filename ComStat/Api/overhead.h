@@ -0,0 +1,141 @@
+#pragma once
+#pragma comment(lib, "psapi.lib")
+
+#include <atomic>
+#include <chrono>
+#include <windows.h>
+#include <psapi.h>
+
+#define OVERHEAD_CPU_BUDGET 0.1
+#define OVERHEAD_REPORT_INTERVAL 60
+
+/// <summary>
+///		Own footprint of the process between measurements: CPU time, resident memory, heap allocations and I/O operations.
+///		Windows has no per-process system call counter, so I/O operations (reads, writes and other I/O requests) stand for them
+/// </summary>
+class SelfOverhead
+{
+
+public:
+
+	/// <summary>
+	///		Overhead since the previous measurement, counts are per sample
+	/// </summary>
+	struct Sample
+	{
+		double CPUPercent {};
+		double CPUMilliseconds {};
+		double ResidentMB {};
+		double Allocations {};
+		double IOOperations {};
+	};
+
+	/// <summary>
+	///		Count heap allocation, it's called by the replaced operator new
+	/// </summary>
+	static void CountAllocation()
+	{
+		AllocationCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	/// <summary>
+	///		Start measuring from now
+	/// </summary>
+	void Begin()
+	{
+		Take(Previous);
+	}
+
+	/// <summary>
+	///		Get overhead since the previous measurement
+	/// </summary>
+	/// 
+	/// <param name="Samples">Number of samples taken since the previous measurement</param>
+	/// 
+	/// <returns>Sample</returns>
+	Sample Measure(unsigned int Samples = 1)
+	{
+		Counters Current {};
+		Sample Result {};
+
+		Take(Current);
+
+		double Seconds { std::chrono::duration <double>(Current.Time - Previous.Time).count() };
+		double Count { (double)(Samples ? Samples : 1) };
+
+		// Process times are in 100-nanosecond intervals
+		Result.CPUMilliseconds = (Current.CPUTime - Previous.CPUTime) / 10000.0 / Count;
+		Result.CPUPercent = Seconds > 0 ? (Current.CPUTime - Previous.CPUTime) / 1e7 / Seconds * 100 : 0;
+		Result.ResidentMB = Current.ResidentBytes / 1048576.0;
+		Result.Allocations = (Current.Allocations - Previous.Allocations) / Count;
+		Result.IOOperations = (Current.IOOperations - Previous.IOOperations) / Count;
+
+		Previous = Current;
+
+		return Result;
+	}
+
+	/// <summary>
+	///		Check if CPU usage exceeds the budget, percent of one core
+	/// </summary>
+	/// 
+	/// <param name="Measured">Sample</param>
+	/// 
+	/// <returns>bool</returns>
+	static bool IsOverBudget(const Sample& Measured)
+	{
+		return Measured.CPUPercent > OVERHEAD_CPU_BUDGET;
+	}
+
+private:
+
+	/// <summary>
+	///		Cumulative process counters
+	/// </summary>
+	struct Counters
+	{
+		std::chrono::steady_clock::time_point Time {};
+		unsigned long long CPUTime {};
+		unsigned long long ResidentBytes {};
+		unsigned long long Allocations {};
+		unsigned long long IOOperations {};
+	};
+
+	/// <summary>
+	///		Read counters of the current process
+	/// </summary>
+	/// 
+	/// <param name="Current">Counters</param>
+	static void Take(Counters& Current)
+	{
+		FILETIME Creation {};
+		FILETIME Exit {};
+		FILETIME Kernel {};
+		FILETIME User {};
+		PROCESS_MEMORY_COUNTERS Memory {};
+		IO_COUNTERS IO {};
+
+		Current.Time = std::chrono::steady_clock::now();
+		Current.Allocations = AllocationCount.load(std::memory_order_relaxed);
+
+		if (GetProcessTimes(GetCurrentProcess(), &Creation, &Exit, &Kernel, &User))
+		{
+			Current.CPUTime = ((unsigned long long)Kernel.dwHighDateTime << 32 | Kernel.dwLowDateTime)
+				+ ((unsigned long long)User.dwHighDateTime << 32 | User.dwLowDateTime);
+		}
+
+		if (GetProcessMemoryInfo(GetCurrentProcess(), &Memory, sizeof(Memory)))
+		{
+			Current.ResidentBytes = Memory.WorkingSetSize;
+		}
+
+		if (GetProcessIoCounters(GetCurrentProcess(), &IO))
+		{
+			Current.IOOperations = IO.ReadOperationCount + IO.WriteOperationCount + IO.OtherOperationCount;
+		}
+	}
+
+	static inline std::atomic <unsigned long long> AllocationCount {};
+
+	Counters Previous {};
+};
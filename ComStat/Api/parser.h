@@ -0,0 +1,285 @@
+#pragma once
+
+#include <cassert>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// <summary>
+///		Splits command into tokens separated by spaces, tabs or commas, without copying.
+///		Comparison operators and quoted strings are separate tokens, quotes are kept
+/// </summary>
+class Tokenizer
+{
+
+public:
+
+	/// <summary>
+	///		Constructor
+	/// </summary>
+	/// 
+	/// <param name="Input">Command</param>
+	explicit Tokenizer(std::wstring_view Input) : Input(Input) {}
+
+	/// <summary>
+	///		Get next token
+	/// </summary>
+	/// 
+	/// <param name="Token">Token</param>
+	/// 
+	/// <returns>bool</returns>
+	bool Next(std::wstring_view& Token)
+	{
+		while (Position < Input.size() && IsSeparator(Input[Position]))
+		{
+			Position++;
+		}
+
+		if (Position == Input.size())
+		{
+			return false;
+		}
+
+		size_t Start { Position };
+
+		if (Input[Position] == L'"')
+		{
+			Position = Input.find(L'"', Position + 1);
+			Position = Position == std::wstring_view::npos ? Input.size() : Position + 1;
+		}
+		else if (IsOperator(Input[Position]))
+		{
+			while (Position < Input.size() && IsOperator(Input[Position]))
+			{
+				Position++;
+			}
+		}
+		else
+		{
+			while (Position < Input.size() && !IsSeparator(Input[Position]) && !IsOperator(Input[Position]) && Input[Position] != L'"')
+			{
+				Position++;
+			}
+		}
+
+		Token = Input.substr(Start, Position - Start);
+
+		return true;
+	}
+
+	/// <summary>
+	///		Case insensitive comparison of token with lowercase keyword
+	/// </summary>
+	/// 
+	/// <param name="Token">Token</param>
+	/// <param name="Keyword">Keyword</param>
+	/// 
+	/// <returns>bool</returns>
+	static bool IsKeyword(std::wstring_view Token, std::wstring_view Keyword)
+	{
+		if (Token.size() != Keyword.size())
+		{
+			return false;
+		}
+
+		for (size_t i = 0; i < Token.size(); i++)
+		{
+			if (ToLower(Token[i]) != Keyword[i])
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/// <summary>
+	///		Convert ASCII symbol to lowercase
+	/// </summary>
+	/// 
+	/// <param name="Symbol">Symbol</param>
+	/// 
+	/// <returns>wchar_t</returns>
+	static wchar_t ToLower(wchar_t Symbol)
+	{
+		return Symbol >= L'A' && Symbol <= L'Z' ? Symbol + (L'a' - L'A') : Symbol;
+	}
+
+private:
+
+	/// <summary>
+	///		Check if symbol separates tokens
+	/// </summary>
+	/// 
+	/// <param name="Symbol">Symbol</param>
+	/// 
+	/// <returns>bool</returns>
+	static bool IsSeparator(wchar_t Symbol)
+	{
+		return Symbol == L' ' || Symbol == L'\t' || Symbol == L',';
+	}
+
+	/// <summary>
+	///		Check if symbol is a part of comparison operator
+	/// </summary>
+	/// 
+	/// <param name="Symbol">Symbol</param>
+	/// 
+	/// <returns>bool</returns>
+	static bool IsOperator(wchar_t Symbol)
+	{
+		return Symbol == L'<' || Symbol == L'>' || Symbol == L'=' || Symbol == L'!';
+	}
+
+	std::wstring_view Input {};
+	size_t Position {};
+};
+
+/// <summary>
+///		Case insensitive open addressing hash table of keywords, keyword value is its index in names list
+/// </summary>
+/// 
+/// <typeparam name="Size">Slots count, power of two greater than keywords count</typeparam>
+template <unsigned int Size>
+class KeywordTable
+{
+	static_assert(Size && !(Size & (Size - 1)), "Size must be a power of two");
+
+public:
+
+	/// <summary>
+	///		Keywords count, one slot stays empty, so lookup of unknown keyword ends
+	/// </summary>
+	static constexpr unsigned int Capacity { Size - 1 };
+
+	/// <summary>
+	///		Constructor
+	/// </summary>
+	KeywordTable() {}
+
+	/// <summary>
+	///		Constructor, names must outlive the table; the first name is "invalid command" and isn't added
+	/// </summary>
+	/// 
+	/// <param name="Names">Keywords names</param>
+	explicit KeywordTable(const std::vector <std::wstring>& Names)
+	{
+		for (size_t i = 1; i < Names.size(); i++)
+		{
+			Add(Names.at(i), (int)i);
+		}
+	}
+
+	/// <summary>
+	///		Add keyword, name must outlive the table. Keyword beyond Capacity is a programming error, a table of known
+	///		keywords must be large enough, so it asserts instead of dropping the keyword
+	/// </summary>
+	/// 
+	/// <param name="Name">Lowercase keyword name</param>
+	/// <param name="Value">Keyword value, greater than 0</param>
+	void Add(std::wstring_view Name, int Value)
+	{
+		assert(Count < Capacity && "KeywordTable is full, its Size must be increased");
+
+		if (Count >= Capacity)
+		{
+			return;
+		}
+
+		unsigned int Slot { Hash(Name, {}) & (Size - 1) };
+
+		while (Slots[Slot].Value)
+		{
+			Slot = (Slot + 1) & (Size - 1);
+		}
+
+		Slots[Slot] = { Name, Value };
+		Count++;
+	}
+
+	/// <summary>
+	///		Find keyword, two tokens are matched as one keyword (e.g. "real time")
+	/// </summary>
+	/// 
+	/// <param name="First">First token</param>
+	/// <param name="Second">Second token</param>
+	/// 
+	/// <returns>int, 0 if not found</returns>
+	int Find(std::wstring_view First, std::wstring_view Second = {}) const
+	{
+		for (unsigned int Slot { Hash(First, Second) & (Size - 1) }; Slots[Slot].Value; Slot = (Slot + 1) & (Size - 1))
+		{
+			if (Equals(Slots[Slot].Name, First, Second))
+			{
+				return Slots[Slot].Value;
+			}
+		}
+
+		return 0;
+	}
+
+private:
+
+	/// <summary>
+	///		FNV-1a hash of lowercase tokens
+	/// </summary>
+	/// 
+	/// <param name="First">First token</param>
+	/// <param name="Second">Second token</param>
+	/// 
+	/// <returns>unsigned int</returns>
+	static unsigned int Hash(std::wstring_view First, std::wstring_view Second)
+	{
+		unsigned int Value { 2166136261u };
+
+		for (wchar_t Symbol : First)
+		{
+			Value = (Value ^ Tokenizer::ToLower(Symbol)) * 16777619u;
+		}
+
+		for (wchar_t Symbol : Second)
+		{
+			Value = (Value ^ Tokenizer::ToLower(Symbol)) * 16777619u;
+		}
+
+		return Value;
+	}
+
+	/// <summary>
+	///		Compare keyword with lowercase tokens
+	/// </summary>
+	/// 
+	/// <param name="Name">Keyword name</param>
+	/// <param name="First">First token</param>
+	/// <param name="Second">Second token</param>
+	/// 
+	/// <returns>bool</returns>
+	static bool Equals(std::wstring_view Name, std::wstring_view First, std::wstring_view Second)
+	{
+		if (Name.size() != First.size() + Second.size())
+		{
+			return false;
+		}
+
+		for (size_t i = 0; i < Name.size(); i++)
+		{
+			if (Name[i] != Tokenizer::ToLower(i < First.size() ? First[i] : Second[i - First.size()]))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/// <summary>
+	///		Table entry
+	/// </summary>
+	struct Entry
+	{
+		std::wstring_view Name {};
+		int Value {};
+	} Slots[Size] {};
+
+	unsigned int Count {};
+};
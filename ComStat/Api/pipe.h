@@ -0,0 +1,335 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <windows.h>
+
+#define PIPE_NAME L"\\\\.\\pipe\\ComStat"
+#define PIPE_INSTANCES 16
+#define PIPE_BUFFER_SIZE 4096
+#define PIPE_MAX_REQUEST 65536
+
+/// <summary>
+///		Local query server on a named pipe, one thread serves all clients through an I/O completion port.
+///		Request is a UTF-8 command line ending with '\n', several requests can be sent without waiting for responses.
+///		Response frame is 4-byte little-endian payload size, 1-byte status (0 - success, 1 - error) and UTF-8 payload
+/// </summary>
+class PipeServer
+{
+
+public:
+
+	/// <summary>
+	///		Request handler, appends response payload and returns status
+	/// </summary>
+	using Handler = std::function<bool(const std::string& Request, std::string& Response)>;
+
+	/// <summary>
+	///		Destructor
+	/// </summary>
+	~PipeServer()
+	{
+		Stop();
+	}
+
+	/// <summary>
+	///		Create pipe instances and wait for clients
+	/// </summary>
+	/// 
+	/// <param name="Respond">Request handler, it's called from Poll</param>
+	/// 
+	/// <returns>bool</returns>
+	bool Start(const Handler& Respond)
+	{
+		Port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1);
+
+		if (!Port)
+		{
+			return false;
+		}
+
+		this->Respond = Respond;
+
+		for (int i = 0; i < PIPE_INSTANCES; i++)
+		{
+			Connections.push_back(std::make_unique<Connection>());
+
+			auto& Client { *Connections.back() };
+
+			// The first instance fails if another server already owns the name
+			Client.Pipe = CreateNamedPipeW(PIPE_NAME, PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED | (i ? 0 : FILE_FLAG_FIRST_PIPE_INSTANCE),
+				PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS, PIPE_INSTANCES, PIPE_BUFFER_SIZE, PIPE_BUFFER_SIZE, 0, nullptr);
+
+			if (Client.Pipe == INVALID_HANDLE_VALUE || !CreateIoCompletionPort(Client.Pipe, Port, 0, 0))
+			{
+				Stop();
+				return false;
+			}
+
+			Listen(Client);
+		}
+
+		return true;
+	}
+
+	/// <summary>
+	///		Close pipes and wait until cancelled operations release their buffers
+	/// </summary>
+	void Stop()
+	{
+		DWORD Bytes {};
+		ULONG_PTR Key {};
+		OVERLAPPED* Overlapped {};
+
+		for (auto& Client : Connections)
+		{
+			if (Client->Pipe != INVALID_HANDLE_VALUE)
+			{
+				CancelIoEx(Client->Pipe, nullptr);
+				CloseHandle(Client->Pipe);
+				Client->Pipe = INVALID_HANDLE_VALUE;
+			}
+		}
+
+		while (Pending && (GetQueuedCompletionStatus(Port, &Bytes, &Key, &Overlapped, 1000) || Overlapped))
+		{
+			Pending--;
+		}
+
+		Connections.clear();
+
+		if (Port)
+		{
+			CloseHandle(Port);
+			Port = nullptr;
+		}
+
+		Pending = 0;
+	}
+
+	/// <summary>
+	///		Process completed operations, waits for the first one no longer than Timeout
+	/// </summary>
+	/// 
+	/// <param name="Timeout">Timeout in milliseconds</param>
+	void Poll(DWORD Timeout)
+	{
+		DWORD Bytes {};
+		ULONG_PTR Key {};
+		OVERLAPPED* Overlapped {};
+
+		// Batch is limited, so the caller regains control under constant load
+		for (int i = 0; i < PIPE_INSTANCES; i++, Timeout = 0)
+		{
+			BOOL bResult { GetQueuedCompletionStatus(Port, &Bytes, &Key, &Overlapped, Timeout) };
+
+			if (!Overlapped)
+			{
+				return;
+			}
+
+			Pending--;
+
+			// OVERLAPPED is the first member of the connection
+			Complete(*(Connection*)Overlapped, bResult ? Bytes : 0, bResult);
+		}
+	}
+
+private:
+
+	/// <summary>
+	///		Connection states enum
+	/// </summary>
+	enum
+	{
+		eConnecting,
+		eReading,
+		eWriting
+	};
+
+	/// <summary>
+	///		Pipe instance and its client buffers
+	/// </summary>
+	struct Connection
+	{
+		OVERLAPPED Overlapped {};
+		HANDLE Pipe { INVALID_HANDLE_VALUE };
+		int State {};
+		char Buffer[PIPE_BUFFER_SIZE] {};
+		std::string Request {};
+		std::string Response {};
+		size_t Written {};
+	};
+
+	/// <summary>
+	///		Wait for the next client
+	/// </summary>
+	/// 
+	/// <param name="Client">Connection</param>
+	void Listen(Connection& Client)
+	{
+		Client.State = eConnecting;
+		Client.Overlapped = {};
+		Client.Request.clear();
+		Client.Response.clear();
+		Client.Written = 0;
+
+		if (ConnectNamedPipe(Client.Pipe, &Client.Overlapped) || GetLastError() == ERROR_IO_PENDING)
+		{
+			Pending++;
+		}
+		// Client connected before the call, no completion is queued for it
+		else if (GetLastError() == ERROR_PIPE_CONNECTED && PostQueuedCompletionStatus(Port, 0, 0, &Client.Overlapped))
+		{
+			Pending++;
+		}
+	}
+
+	/// <summary>
+	///		Drop client and wait for the next one
+	/// </summary>
+	/// 
+	/// <param name="Client">Connection</param>
+	void Reset(Connection& Client)
+	{
+		DisconnectNamedPipe(Client.Pipe);
+		Listen(Client);
+	}
+
+	/// <summary>
+	///		Start reading requests
+	/// </summary>
+	/// 
+	/// <param name="Client">Connection</param>
+	void Read(Connection& Client)
+	{
+		Client.State = eReading;
+		Client.Overlapped = {};
+
+		// Completion is queued even if the read finishes at once
+		if (ReadFile(Client.Pipe, Client.Buffer, sizeof(Client.Buffer), nullptr, &Client.Overlapped) || GetLastError() == ERROR_IO_PENDING)
+		{
+			Pending++;
+			return;
+		}
+
+		Reset(Client);
+	}
+
+	/// <summary>
+	///		Start writing the rest of responses
+	/// </summary>
+	/// 
+	/// <param name="Client">Connection</param>
+	void Write(Connection& Client)
+	{
+		Client.State = eWriting;
+		Client.Overlapped = {};
+
+		if (WriteFile(Client.Pipe, Client.Response.data() + Client.Written, (DWORD)(Client.Response.size() - Client.Written), nullptr, &Client.Overlapped)
+			|| GetLastError() == ERROR_IO_PENDING)
+		{
+			Pending++;
+			return;
+		}
+
+		Reset(Client);
+	}
+
+	/// <summary>
+	///		Advance connection state after completed operation
+	/// </summary>
+	/// 
+	/// <param name="Client">Connection</param>
+	/// <param name="Bytes">Transferred bytes</param>
+	/// <param name="IsSuccess">Operation succeeded</param>
+	void Complete(Connection& Client, DWORD Bytes, bool IsSuccess)
+	{
+		if (!IsSuccess)
+		{
+			Reset(Client);
+			return;
+		}
+
+		switch (Client.State)
+		{
+		case eConnecting:
+		{
+			Read(Client);
+		} break;
+
+		case eReading:
+		{
+			Client.Request.append(Client.Buffer, Bytes);
+
+			// Every complete line gets its frame, responses keep requests order
+			for (size_t End; (End = Client.Request.find('\n')) != std::string::npos;)
+			{
+				size_t Size { End && Client.Request.at(End - 1) == '\r' ? End - 1 : End };
+
+				AppendFrame(Client.Response, Client.Request.substr(0, Size));
+				Client.Request.erase(0, End + 1);
+			}
+
+			if (Client.Request.size() > PIPE_MAX_REQUEST)
+			{
+				Reset(Client);
+			}
+			else if (Client.Response.empty())
+			{
+				Read(Client);
+			}
+			else
+			{
+				Write(Client);
+			}
+		} break;
+
+		case eWriting:
+		{
+			Client.Written += Bytes;
+
+			if (Client.Written < Client.Response.size())
+			{
+				Write(Client);
+				break;
+			}
+
+			Client.Response.clear();
+			Client.Written = 0;
+
+			Read(Client);
+		} break;
+		}
+	}
+
+	/// <summary>
+	///		Append response frame for one request
+	/// </summary>
+	/// 
+	/// <param name="Output">Output buffer</param>
+	/// <param name="Request">Request</param>
+	void AppendFrame(std::string& Output, const std::string& Request)
+	{
+		size_t Start { Output.size() };
+
+		Output.append(5, '\0');
+
+		bool bSuccess { Respond(Request, Output) };
+		size_t Size { Output.size() - Start - 5 };
+
+		for (int i = 0; i < 4; i++)
+		{
+			Output.at(Start + i) = (char)(Size >> (i * 8));
+		}
+
+		Output.at(Start + 4) = bSuccess ? 0 : 1;
+	}
+
+	std::vector <std::unique_ptr<Connection>> Connections {};
+	Handler Respond {};
+	HANDLE Port {};
+	size_t Pending {};
+};
@@ -0,0 +1,345 @@
+#pragma once
+
+#include <algorithm>
+#include <cwchar>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../Api/fields.h"
+#include "../Api/parser.h"
+
+/// <summary>
+///		Compiled "where" conditions and "order by" field of inventory query
+/// </summary>
+class Query
+{
+
+public:
+
+	/// <summary>
+	///		Comparison operators enum
+	/// </summary>
+	enum
+	{
+		eEqual,
+		eNotEqual,
+		eLess,
+		eLessEqual,
+		eGreater,
+		eGreaterEqual
+	};
+
+	/// <summary>
+	///		Remove conditions and order
+	/// </summary>
+	void Clear()
+	{
+		Conditions.clear();
+		OrderField = nullptr;
+		bDescending = false;
+	}
+
+	/// <summary>
+	///		Compile condition, e.g. "freespace < 10" or "mac != """
+	/// </summary>
+	/// 
+	/// <param name="Field">Field</param>
+	/// <param name="Operator">Operator token</param>
+	/// <param name="Literal">Literal token</param>
+	/// 
+	/// <returns>bool</returns>
+	bool AddCondition(const Fields::Field& Field, std::wstring_view Operator, std::wstring_view Literal)
+	{
+		Condition NewCondition {};
+		NewCondition.Field = &Field;
+
+		if (Operator == L"=" || Operator == L"==")
+		{
+			NewCondition.Operator = eEqual;
+		}
+		else if (Operator == L"!=" || Operator == L"<>")
+		{
+			NewCondition.Operator = eNotEqual;
+		}
+		else if (Operator == L"<")
+		{
+			NewCondition.Operator = eLess;
+		}
+		else if (Operator == L"<=")
+		{
+			NewCondition.Operator = eLessEqual;
+		}
+		else if (Operator == L">")
+		{
+			NewCondition.Operator = eGreater;
+		}
+		else if (Operator == L">=")
+		{
+			NewCondition.Operator = eGreaterEqual;
+		}
+		else
+		{
+			return false;
+		}
+
+		// Quotes are optional
+		if (Literal.size() && Literal.front() == L'"')
+		{
+			Literal.remove_prefix(1);
+
+			if (Literal.size() && Literal.back() == L'"')
+			{
+				Literal.remove_suffix(1);
+			}
+		}
+
+		if (Field.Format == Fields::eText)
+		{
+			NewCondition.Text = Literal;
+		}
+		else if (!ParseNumber(Field, Literal, NewCondition.Number))
+		{
+			return false;
+		}
+
+		Conditions.push_back(NewCondition);
+
+		return true;
+	}
+
+	/// <summary>
+	///		Set sort field
+	/// </summary>
+	/// 
+	/// <param name="Field">Field</param>
+	/// <param name="IsDescending">Sort in descending order</param>
+	void SetOrder(const Fields::Field& Field, bool IsDescending)
+	{
+		OrderField = &Field;
+		bDescending = IsDescending;
+	}
+
+	/// <summary>
+	///		Select records matching all conditions in one pass and sort them
+	/// </summary>
+	/// 
+	/// <param name="Category">Category</param>
+	/// <param name="Statistics">Inventory</param>
+	/// <param name="Rows">Selected records indices</param>
+	void Select(const Fields::Category& Category, const ComputerStatistics& Statistics, std::vector <size_t>& Rows)
+	{
+		size_t Count { Category.Count(Statistics) };
+
+		Rows.clear();
+
+		for (size_t i = 0; i < Count; i++)
+		{
+			const void* Record { Category.Record(Statistics, i) };
+
+			if (std::all_of(Conditions.begin(), Conditions.end(), [&](const Condition& Check) { return Matches(Check, Record); }))
+			{
+				Rows.push_back(i);
+			}
+		}
+
+		if (!OrderField || Rows.size() < 2)
+		{
+			return;
+		}
+
+		// Sort keys are read once per record
+		Keys.clear();
+
+		for (size_t Row : Rows)
+		{
+			Fields::Value Key { OrderField->Get(Category.Record(Statistics, Row)) };
+
+			Keys.push_back({ Row, OrderField->Format == Fields::eText ? Key.String : nullptr, ToNumber(*OrderField, Key) });
+		}
+
+		std::stable_sort(Keys.begin(), Keys.end(), [&](const SortKey& Left, const SortKey& Right) {
+			int Result { Left.Text ? CompareText(*Left.Text, *Right.Text) : (Left.Number < Right.Number ? -1 : Left.Number > Right.Number) };
+
+			return bDescending ? Result > 0 : Result < 0;
+		});
+
+		for (size_t i = 0; i < Keys.size(); i++)
+		{
+			Rows.at(i) = Keys.at(i).Row;
+		}
+	}
+
+private:
+
+	/// <summary>
+	///		Compiled condition
+	/// </summary>
+	struct Condition
+	{
+		const Fields::Field* Field {};
+		int Operator {};
+		std::wstring Text {};
+		double Number {};
+	};
+
+	/// <summary>
+	///		Record sort key
+	/// </summary>
+	struct SortKey
+	{
+		size_t Row {};
+		const std::wstring* Text {};
+		double Number {};
+	};
+
+	/// <summary>
+	///		Check condition against record
+	/// </summary>
+	/// 
+	/// <param name="Check">Condition</param>
+	/// <param name="Record">Record</param>
+	/// 
+	/// <returns>bool</returns>
+	static bool Matches(const Condition& Check, const void* Record)
+	{
+		Fields::Value FieldValue { Check.Field->Get(Record) };
+		int Result {};
+
+		if (Check.Field->Format == Fields::eText)
+		{
+			Result = CompareText(*FieldValue.String, Check.Text);
+		}
+		else
+		{
+			double Number { ToNumber(*Check.Field, FieldValue) };
+			Result = Number < Check.Number ? -1 : Number > Check.Number;
+		}
+
+		switch (Check.Operator)
+		{
+		case eEqual:
+			return Result == 0;
+		case eNotEqual:
+			return Result != 0;
+		case eLess:
+			return Result < 0;
+		case eLessEqual:
+			return Result <= 0;
+		case eGreater:
+			return Result > 0;
+		case eGreaterEqual:
+			return Result >= 0;
+		}
+
+		return false;
+	}
+
+	/// <summary>
+	///		Case insensitive comparison
+	/// </summary>
+	/// 
+	/// <param name="Left">Left string</param>
+	/// <param name="Right">Right string</param>
+	/// 
+	/// <returns>int</returns>
+	static int CompareText(std::wstring_view Left, std::wstring_view Right)
+	{
+		for (size_t i = 0; i < Left.size() && i < Right.size(); i++)
+		{
+			wchar_t LeftSymbol { Tokenizer::ToLower(Left[i]) };
+			wchar_t RightSymbol { Tokenizer::ToLower(Right[i]) };
+
+			if (LeftSymbol != RightSymbol)
+			{
+				return LeftSymbol < RightSymbol ? -1 : 1;
+			}
+		}
+
+		return Left.size() < Right.size() ? -1 : Left.size() > Right.size();
+	}
+
+	/// <summary>
+	///		Get numeric value of the field, resolution is compared by width, then by height
+	/// </summary>
+	/// 
+	/// <param name="Field">Field</param>
+	/// <param name="FieldValue">Value</param>
+	/// 
+	/// <returns>double</returns>
+	static double ToNumber(const Fields::Field& Field, const Fields::Value& FieldValue)
+	{
+		switch (Field.Format)
+		{
+		case Fields::eReal:
+			return FieldValue.Real;
+		case Fields::eResolution:
+			return FieldValue.Integer * 100000.0 + FieldValue.Second;
+		}
+
+		return (double)FieldValue.Integer;
+	}
+
+	/// <summary>
+	///		Parse numeric literal, e.g. "10", "yes", "ssd" or "1920x1080"
+	/// </summary>
+	/// 
+	/// <param name="Field">Field</param>
+	/// <param name="Literal">Literal</param>
+	/// <param name="Number">Parsed number</param>
+	/// 
+	/// <returns>bool</returns>
+	static bool ParseNumber(const Fields::Field& Field, std::wstring_view Literal, double& Number)
+	{
+		std::wstring Text { Literal };
+		wchar_t* End {};
+
+		if (Field.Format == Fields::eYesNo && (Tokenizer::IsKeyword(Literal, L"yes") || Tokenizer::IsKeyword(Literal, L"true")))
+		{
+			Number = 1;
+			return true;
+		}
+
+		if (Field.Format == Fields::eYesNo && (Tokenizer::IsKeyword(Literal, L"no") || Tokenizer::IsKeyword(Literal, L"false")))
+		{
+			Number = 0;
+			return true;
+		}
+
+		if (Field.Format == Fields::eMediaType && (Tokenizer::IsKeyword(Literal, L"ssd") || Tokenizer::IsKeyword(Literal, L"hdd")))
+		{
+			Number = Tokenizer::IsKeyword(Literal, L"ssd") ? 4 : 3;
+			return true;
+		}
+
+		Number = std::wcstod(Text.c_str(), &End);
+
+		if (End == Text.c_str())
+		{
+			return false;
+		}
+
+		// Resolution height
+		if (Field.Format == Fields::eResolution)
+		{
+			Number *= 100000.0;
+
+			if (*End == L'x' || *End == L'X')
+			{
+				const wchar_t* Height { End + 1 };
+				Number += std::wcstod(Height, &End);
+
+				if (End == Height)
+				{
+					return false;
+				}
+			}
+		}
+
+		return *End == L'\0';
+	}
+
+	std::vector <Condition> Conditions {};
+	std::vector <SortKey> Keys {};
+	const Fields::Field* OrderField {};
+	bool bDescending {};
+};
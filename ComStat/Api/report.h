@@ -0,0 +1,225 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../Api/fields.h"
+#include "../Api/parser.h"
+#include "../Api/query.h"
+#include "../Api/serializer.h"
+
+/// <summary>
+///		Category queries parsing and records text, "save" and serializer layouts, they don't depend on the console
+/// </summary>
+namespace Report
+{
+	/// <summary>
+	///		Parse category clauses: "get" sub commands, "where" conditions and "order by" field
+	/// </summary>
+	/// 
+	/// <param name="Tokens">Tokenizer</param>
+	/// <param name="Token">First clause token</param>
+	/// <param name="Category">Category</param>
+	/// <param name="SubCommands">Sub commands lookup table of the category</param>
+	/// <param name="Filter">Query</param>
+	/// <param name="SubCommandIndex">Requested sub commands indices</param>
+	/// 
+	/// <returns>bool</returns>
+	inline bool ParseQuery(Tokenizer& Tokens, std::wstring_view Token, const Fields::Category& Category, const KeywordTable <16>& SubCommands,
+		Query& Filter, std::vector <int>& SubCommandIndex)
+	{
+		bool bNext { true };
+
+		// Sub commands, at least one is required
+		if (Tokenizer::IsKeyword(Token, L"get"))
+		{
+			while ((bNext = Tokens.Next(Token)) && !Tokenizer::IsKeyword(Token, L"where") && !Tokenizer::IsKeyword(Token, L"order"))
+			{
+				int Index { SubCommands.Find(Token) };
+
+				if (!Index)
+				{
+					return false;
+				}
+
+				SubCommandIndex.push_back(Index);
+			}
+
+			if (SubCommandIndex.empty())
+			{
+				return false;
+			}
+		}
+
+		// Conditions joined with "and"
+		if (bNext && Tokenizer::IsKeyword(Token, L"where"))
+		{
+			do
+			{
+				std::wstring_view Operator {};
+				std::wstring_view Literal {};
+				int FieldIndex {};
+
+				if (!Tokens.Next(Token) || !(FieldIndex = SubCommands.Find(Token))
+					|| !Tokens.Next(Operator) || !Tokens.Next(Literal)
+					|| !Filter.AddCondition(Category.Fields.at(FieldIndex - 1), Operator, Literal))
+				{
+					return false;
+				}
+			} while ((bNext = Tokens.Next(Token)) && Tokenizer::IsKeyword(Token, L"and"));
+		}
+
+		// Sort field and optional direction
+		if (bNext && Tokenizer::IsKeyword(Token, L"order"))
+		{
+			int FieldIndex {};
+			bool bDescending {};
+
+			if (!Tokens.Next(Token) || !Tokenizer::IsKeyword(Token, L"by") || !Tokens.Next(Token) || !(FieldIndex = SubCommands.Find(Token)))
+			{
+				return false;
+			}
+
+			if ((bNext = Tokens.Next(Token)) && (Tokenizer::IsKeyword(Token, L"asc") || (bDescending = Tokenizer::IsKeyword(Token, L"desc"))))
+			{
+				bNext = Tokens.Next(Token);
+			}
+
+			Filter.SetOrder(Category.Fields.at(FieldIndex - 1), bDescending);
+		}
+
+		return !bNext;
+	}
+
+	/// <summary>
+	///		Title of category section, e.g. "|          Disks         |"
+	/// </summary>
+	/// 
+	/// <param name="Category">Category</param>
+	/// <param name="Border">Border symbol</param>
+	/// 
+	/// <returns>std::wstring</returns>
+	inline std::wstring CategoryTitle(const Fields::Category& Category, wchar_t Border)
+	{
+		std::wstring Title(26, L' ');
+
+		Title.front() = Title.back() = Border;
+		Title.replace(1 + (25 - Category.Title.size()) / 2, Category.Title.size(), Category.Title);
+
+		return Title;
+	}
+
+	/// <summary>
+	///		Format field value of the record
+	/// </summary>
+	/// 
+	/// <param name="Field">Field</param>
+	/// <param name="Record">Record</param>
+	/// <param name="FieldText">Text buffer, it's reused between fields</param>
+	/// 
+	/// <returns>const std::wstring&</returns>
+	inline const std::wstring& FormatField(const Fields::Field& Field, const void* Record, std::wstring& FieldText)
+	{
+		FieldText.clear();
+		Fields::Format(Field, Field.Get(Record), FieldText);
+
+		return FieldText;
+	}
+
+	/// <summary>
+	///		Append record as console prints it, labels are aligned with tabs at the column
+	/// </summary>
+	/// 
+	/// <param name="Category">Category</param>
+	/// <param name="Record">Record</param>
+	/// <param name="Column">Values column, see Fields::LabelColumn</param>
+	/// <param name="Text">Output</param>
+	/// <param name="FieldText">Text buffer</param>
+	inline void AppendRecord(const Fields::Category& Category, const void* Record, size_t Column, std::wstring& Text, std::wstring& FieldText)
+	{
+		for (auto& Field : Category.Fields)
+		{
+			Text.append(Field.Label).push_back(L':');
+
+			for (size_t Position = (Field.Label.size() + 1) / 8 * 8; Position < Column; Position += 8)
+			{
+				Text.push_back(L'\t');
+			}
+
+			Text.append(FormatField(Field, Record, FieldText)).push_back(L'\n');
+		}
+	}
+
+	/// <summary>
+	///		Append record as "save" writes it, e.g. "Model: Samsung SSD 970", in UTF-8
+	/// </summary>
+	/// 
+	/// <param name="Category">Category</param>
+	/// <param name="Record">Record</param>
+	/// <param name="Text">Output</param>
+	/// <param name="FieldText">Text buffer</param>
+	inline void SaveRecord(const Fields::Category& Category, const void* Record, std::string& Text, std::wstring& FieldText)
+	{
+		for (auto& Field : Category.Fields)
+		{
+			Serializer::AppendUTF8(Text, Field.Label);
+			Text.append(": ");
+			Serializer::AppendUTF8(Text, FormatField(Field, Record, FieldText));
+			Text.push_back('\n');
+		}
+	}
+
+	/// <summary>
+	///		Serialize field of the record, resolution is written as text
+	/// </summary>
+	/// 
+	/// <param name="Output">Serializer</param>
+	/// <param name="Field">Field</param>
+	/// <param name="Record">Record</param>
+	/// <param name="FieldText">Text buffer</param>
+	inline void SerializeField(Serializer& Output, const Fields::Field& Field, const void* Record, std::wstring& FieldText)
+	{
+		Fields::Value Value { Field.Get(Record) };
+
+		switch (Field.Format)
+		{
+		case Fields::eText: Output.Field(Field.Name, *Value.String); break;
+		case Fields::eInteger: Output.Field(Field.Name, Value.Integer); break;
+		case Fields::eReal: Output.Field(Field.Name, Value.Real); break;
+		case Fields::eYesNo: Output.Field(Field.Name, Value.Integer != 0); break;
+		case Fields::eMediaType: Output.Field(Field.Name, Value.Integer); break;
+		case Fields::eResolution: Output.Field(Field.Name, FormatField(Field, Record, FieldText)); break;
+		}
+	}
+
+	/// <summary>
+	///		Serialize record
+	/// </summary>
+	/// 
+	/// <param name="Output">Serializer</param>
+	/// <param name="Category">Category</param>
+	/// <param name="Record">Record</param>
+	/// <param name="FieldIndices">Requested sub commands indices, all fields if empty</param>
+	/// <param name="FieldText">Text buffer</param>
+	inline void SerializeRecord(Serializer& Output, const Fields::Category& Category, const void* Record, const std::vector <int>& FieldIndices, std::wstring& FieldText)
+	{
+		Output.BeginRecord();
+
+		if (FieldIndices.empty())
+		{
+			for (auto& Field : Category.Fields)
+			{
+				SerializeField(Output, Field, Record, FieldText);
+			}
+		}
+		else
+		{
+			for (int Index : FieldIndices)
+			{
+				SerializeField(Output, Category.Fields.at(Index - 1), Record, FieldText);
+			}
+		}
+
+		Output.EndRecord();
+	}
+}
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <windows.h>
+#include "../Api/compress.h"
+#include "../Api/trace.h"
+
+#define ROTATION_MAX_SIZE (16 * 1048576)
+#define ROTATION_MAX_AGE (24 * 60 * 60)
+#define ROTATION_RETENTION 8
+
+/// <summary>
+///		Size and age based rotation of log files. Full file is renamed to a segment with timestamp, e.g. logs\log-20240101-120000.csv,
+///		segments are compressed and the oldest ones beyond retention are deleted by a low priority background thread
+/// </summary>
+class LogRotation
+{
+
+public:
+
+	/// <summary>
+	///		Destructor, the segment being compacted is finished, the rest is compacted by the next rotation
+	/// </summary>
+	~LogRotation()
+	{
+		if (!Worker.joinable())
+		{
+			return;
+		}
+
+		{
+			std::lock_guard <std::mutex> Lock(Mutex);
+			bStop = true;
+		}
+
+		Ready.notify_one();
+		Worker.join();
+	}
+
+	/// <summary>
+	///		Check if file reached size or age limit
+	/// </summary>
+	/// 
+	/// <param name="Path">File</param>
+	/// 
+	/// <returns>bool</returns>
+	bool IsDue(const std::wstring& Path)
+	{
+		WIN32_FILE_ATTRIBUTE_DATA Data {};
+		FILETIME Now {};
+
+		if (!GetFileAttributesExW(Path.c_str(), GetFileExInfoStandard, &Data))
+		{
+			return false;
+		}
+
+		GetSystemTimeAsFileTime(&Now);
+
+		unsigned long long Size { (unsigned long long)Data.nFileSizeHigh << 32 | Data.nFileSizeLow };
+		unsigned long long Age { (ToInteger(Now) - std::min(ToInteger(Now), ToInteger(Data.ftCreationTime))) / 10000000 };
+
+		return Size && (Size >= ROTATION_MAX_SIZE || Age >= ROTATION_MAX_AGE);
+	}
+
+	/// <summary>
+	///		Rename file to segment and queue compaction, the caller closes the file before and opens it again after
+	/// </summary>
+	/// 
+	/// <param name="Path">File</param>
+	/// 
+	/// <returns>bool, false if the file is kept, e.g. it's opened by another program</returns>
+	bool Rotate(const std::wstring& Path)
+	{
+		size_t Name { Path.find_last_of(L'\\') + 1 };
+		size_t Extension { std::min(Path.find(L'.', Name), Path.size()) };
+		SYSTEMTIME Time {};
+		wchar_t Stamp[32] {};
+
+		GetLocalTime(&Time);
+		swprintf(Stamp, 32, L"-%04u%02u%02u-%02u%02u%02u", Time.wYear, Time.wMonth, Time.wDay, Time.wHour, Time.wMinute, Time.wSecond);
+
+		if (!MoveFileExW(Path.c_str(), (Path.substr(0, Extension) + Stamp + Path.substr(Extension)).c_str(), 0))
+		{
+			return false;
+		}
+
+		// New file gets the old creation time if it's created soon after rename (file system tunneling), so it's set explicitly
+		HANDLE File { CreateFileW(Path.c_str(), FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr) };
+
+		if (File != INVALID_HANDLE_VALUE)
+		{
+			FILETIME Now {};
+
+			GetSystemTimeAsFileTime(&Now);
+			SetFileTime(File, &Now, nullptr, nullptr);
+			CloseHandle(File);
+		}
+
+		{
+			std::lock_guard <std::mutex> Lock(Mutex);
+
+			// Segments of both plain and compressed files, e.g. logs\log-*.csv*
+			std::wstring Pattern { Path.substr(0, Extension) + L"-*" + Path.substr(Extension, Path.find(L'.', Extension + 1) - Extension) + L"*" };
+
+			if (std::find(Patterns.begin(), Patterns.end(), Pattern) == Patterns.end())
+			{
+				Patterns.push_back(Pattern);
+			}
+
+			if (!Worker.joinable())
+			{
+				Worker = std::thread(&LogRotation::Compact, this);
+			}
+		}
+
+		Ready.notify_one();
+
+		return true;
+	}
+
+private:
+
+	/// <summary>
+	///		Convert file time to 100-nanosecond intervals
+	/// </summary>
+	/// 
+	/// <param name="Time">File time</param>
+	/// 
+	/// <returns>unsigned long long</returns>
+	static unsigned long long ToInteger(const FILETIME& Time)
+	{
+		return (unsigned long long)Time.dwHighDateTime << 32 | Time.dwLowDateTime;
+	}
+
+	/// <summary>
+	///		Compaction thread, it has background priority, so sampling and disk I/O of other programs go first
+	/// </summary>
+	void Compact()
+	{
+		SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+
+		std::unique_lock <std::mutex> Lock(Mutex);
+
+		for (;;)
+		{
+			Ready.wait(Lock, [this]() { return bStop || !Patterns.empty(); });
+
+			if (bStop)
+			{
+				return;
+			}
+
+			std::wstring Pattern { std::move(Patterns.front()) };
+			Patterns.pop_front();
+			Lock.unlock();
+
+			std::vector <std::wstring> Segments {};
+			std::wstring Directory { Pattern.substr(0, Pattern.find_last_of(L'\\') + 1) };
+			WIN32_FIND_DATAW Data {};
+			HANDLE Find { FindFirstFileW(Pattern.c_str(), &Data) };
+
+			if (Find != INVALID_HANDLE_VALUE)
+			{
+				do
+				{
+					std::wstring Segment { Directory + Data.cFileName };
+
+					// Compaction was interrupted by exit
+					if (Segment.size() > 4 && Segment.compare(Segment.size() - 4, 4, L".tmp") == 0)
+					{
+						DeleteFileW(Segment.c_str());
+						continue;
+					}
+
+					Segments.push_back(Segment);
+				} while (FindNextFileW(Find, &Data));
+
+				FindClose(Find);
+			}
+
+			// Timestamps sort segments from the oldest
+			std::sort(Segments.begin(), Segments.end());
+
+			for (size_t i = 0; i < Segments.size(); i++)
+			{
+				if (i + ROTATION_RETENTION < Segments.size())
+				{
+					DeleteFileW(Segments.at(i).c_str());
+				}
+				else if (Segments.at(i).size() < 3 || Segments.at(i).compare(Segments.at(i).size() - 3, 3, COMPRESSED_EXTENSION) != 0)
+				{
+					CompactSegment(Segments.at(i));
+				}
+			}
+
+			Lock.lock();
+		}
+	}
+
+	/// <summary>
+	///		Compress segment, the plain segment is deleted only after the compressed one is complete
+	/// </summary>
+	/// 
+	/// <param name="Path">Segment</param>
+	void CompactSegment(const std::wstring& Path)
+	{
+		Trace::Span Span { "CompactSegment", "io", Path };
+		std::ifstream Input(Path, std::ios::in | std::ios::binary);
+		std::ostringstream Content {};
+		std::string Output {};
+		std::wstring Temporary { Path + L".tmp" };
+
+		if (!Input.is_open())
+		{
+			return;
+		}
+
+		Content << Input.rdbuf();
+		Input.close();
+
+		std::string Text { Content.str() };
+
+		for (size_t i = 0; i < Text.size(); i += COMPRESSION_BLOCK_SIZE)
+		{
+			BlockCompression::AppendBlock(std::string_view(Text).substr(i, COMPRESSION_BLOCK_SIZE), Output);
+		}
+
+		std::ofstream File(Temporary, std::ios::out | std::ios::trunc | std::ios::binary);
+
+		File.write(Output.data(), Output.size());
+		File.close();
+
+		if (File.fail() || !MoveFileExW(Temporary.c_str(), (Path + COMPRESSED_EXTENSION).c_str(), MOVEFILE_REPLACE_EXISTING))
+		{
+			DeleteFileW(Temporary.c_str());
+			return;
+		}
+
+		DeleteFileW(Path.c_str());
+	}
+
+	std::deque <std::wstring> Patterns {};
+	std::thread Worker {};
+	std::mutex Mutex {};
+	std::condition_variable Ready {};
+	bool bStop {};
+};
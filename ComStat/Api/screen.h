@@ -0,0 +1,282 @@
+#pragma once
+
+#include <algorithm>
+#include <cwchar>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#define SCREEN_SKIP_LIMIT 4
+
+/// <summary>
+///		Double-buffered character screen, frames are drawn into the back buffer and only cells which differ
+///		from the front buffer are written as ANSI escape sequences
+/// </summary>
+class ScreenBuffer
+{
+
+public:
+
+	/// <summary>
+	///		Cell colors, they are written as SGR foreground codes
+	/// </summary>
+	enum Colors : unsigned char
+	{
+		eDefault,
+		eRed,
+		eGreen,
+		eYellow,
+		eCyan,
+		eGray
+	};
+
+	/// <summary>
+	///		Change screen size, the next frame is written completely
+	/// </summary>
+	/// 
+	/// <param name="NewColumns">Columns count</param>
+	/// <param name="NewRows">Rows count</param>
+	void Resize(int NewColumns, int NewRows)
+	{
+		Columns = std::max(NewColumns, 0);
+		Rows = std::max(NewRows, 0);
+
+		Back.assign((size_t)Columns * Rows, Cell {});
+		Front.assign((size_t)Columns * Rows, Cell {});
+
+		bInvalid = true;
+	}
+
+	/// <summary>
+	///		Write the next frame completely, e.g. after something else was printed
+	/// </summary>
+	void Invalidate()
+	{
+		bInvalid = true;
+	}
+
+	/// <summary>
+	///		Get columns count
+	/// </summary>
+	/// 
+	/// <returns>int</returns>
+	int GetColumns() const
+	{
+		return Columns;
+	}
+
+	/// <summary>
+	///		Get rows count
+	/// </summary>
+	/// 
+	/// <returns>int</returns>
+	int GetRows() const
+	{
+		return Rows;
+	}
+
+	/// <summary>
+	///		Start drawing a new frame, back buffer is filled with spaces
+	/// </summary>
+	void Clear()
+	{
+		std::fill(Back.begin(), Back.end(), Cell {});
+	}
+
+	/// <summary>
+	///		Draw text, it's clipped at the screen edge
+	/// </summary>
+	/// 
+	/// <param name="Column">Column</param>
+	/// <param name="Row">Row</param>
+	/// <param name="Text">Text</param>
+	/// <param name="Color">Color</param>
+	/// 
+	/// <returns>int, column after the text</returns>
+	int Text(int Column, int Row, std::wstring_view Text, Colors Color = eDefault)
+	{
+		if (Row < 0 || Row >= Rows)
+		{
+			return Column + (int)Text.size();
+		}
+
+		for (size_t i = 0; i < Text.size(); i++, Column++)
+		{
+			if (Column < 0 || Column >= Columns)
+			{
+				continue;
+			}
+
+			// Control symbols would move the cursor of the terminal
+			Back.at((size_t)Row * Columns + Column) = { Text.at(i) < L' ' ? L' ' : Text.at(i), Color };
+		}
+
+		return Column;
+	}
+
+	/// <summary>
+	///		Draw load bar, e.g. [|||||     ], its color depends on the load
+	/// </summary>
+	/// 
+	/// <param name="Column">Column</param>
+	/// <param name="Row">Row</param>
+	/// <param name="Width">Width including brackets</param>
+	/// <param name="Percent">Load in %</param>
+	/// 
+	/// <returns>int, column after the bar</returns>
+	int Bar(int Column, int Row, int Width, float Percent)
+	{
+		if (Width < 3)
+		{
+			return Column;
+		}
+
+		int Filled { (int)(std::clamp(Percent, 0.0f, 100.0f) / 100 * (Width - 2) + 0.5f) };
+
+		Colors Color { Percent >= 90 ? eRed : Percent >= 70 ? eYellow : eGreen };
+
+		Text(Column, Row, L"[", eGray);
+
+		for (int i = 0; i < Filled; i++)
+		{
+			Text(Column + 1 + i, Row, L"|", Color);
+		}
+
+		Text(Column + Width - 1, Row, L"]", eGray);
+
+		return Column + Width;
+	}
+
+	/// <summary>
+	///		Append escape sequences of changed cells and make the back buffer the front one.
+	///		Cursor is moved only when changed cells aren't adjacent, short unchanged gaps are written again instead
+	/// </summary>
+	/// 
+	/// <param name="Out">Output</param>
+	void Render(std::wstring& Out)
+	{
+		int CursorRow { -1 };
+		int CursorColumn { -1 };
+		int CurrentColor { -1 };
+
+		if (bInvalid)
+		{
+			Out.append(L"\x1b[0m\x1b[2J");
+		}
+
+		for (int Row = 0; Row < Rows; Row++)
+		{
+			for (int Column = 0; Column < Columns; Column++)
+			{
+				size_t Index { (size_t)Row * Columns + Column };
+
+				if (!bInvalid && Back.at(Index) == Front.at(Index))
+				{
+					continue;
+				}
+
+				if (Row != CursorRow || CursorColumn < 0 || Column - CursorColumn > SCREEN_SKIP_LIMIT
+					|| !IsUniform(Index - (Column - CursorColumn), Index, CurrentColor))
+				{
+					AppendPosition(Out, Row, Column);
+				}
+				else
+				{
+					// Unchanged cells are shorter than a cursor movement
+					for (size_t i = Index - (Column - CursorColumn); i < Index; i++)
+					{
+						Out.push_back(Back.at(i).Symbol);
+					}
+				}
+
+				if (Back.at(Index).Color != CurrentColor)
+				{
+					CurrentColor = Back.at(Index).Color;
+					AppendColor(Out, CurrentColor);
+				}
+
+				Out.push_back(Back.at(Index).Symbol);
+
+				// Cursor stays at the last column until the next symbol, its position is set again
+				CursorRow = Row;
+				CursorColumn = Column + 1 < Columns ? Column + 1 : -1;
+			}
+		}
+
+		Front = Back;
+		bInvalid = false;
+	}
+
+private:
+
+	/// <summary>
+	///		Screen cell
+	/// </summary>
+	struct Cell
+	{
+		wchar_t Symbol { L' ' };
+		unsigned char Color { eDefault };
+
+		bool operator == (const Cell& Other) const
+		{
+			return Symbol == Other.Symbol && Color == Other.Color;
+		}
+	};
+
+	/// <summary>
+	///		Check if cells have the current color, so they can be written again without color changes
+	/// </summary>
+	/// 
+	/// <param name="Begin">First cell index</param>
+	/// <param name="End">Cell index after the last one</param>
+	/// <param name="Color">Current color</param>
+	/// 
+	/// <returns>bool</returns>
+	bool IsUniform(size_t Begin, size_t End, int Color) const
+	{
+		for (size_t i = Begin; i < End; i++)
+		{
+			if (Back.at(i).Color != Color)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/// <summary>
+	///		Append cursor position, CUP rows and columns start at 1
+	/// </summary>
+	/// 
+	/// <param name="Out">Output</param>
+	/// <param name="Row">Row</param>
+	/// <param name="Column">Column</param>
+	static void AppendPosition(std::wstring& Out, int Row, int Column)
+	{
+		wchar_t Sequence[32] {};
+		int Length { Column ? swprintf(Sequence, sizeof(Sequence) / sizeof(Sequence[0]), L"\x1b[%d;%dH", Row + 1, Column + 1)
+			: swprintf(Sequence, sizeof(Sequence) / sizeof(Sequence[0]), L"\x1b[%dH", Row + 1) };
+
+		Out.append(Sequence, Length > 0 ? Length : 0);
+	}
+
+	/// <summary>
+	///		Append foreground color
+	/// </summary>
+	/// 
+	/// <param name="Out">Output</param>
+	/// <param name="Color">Color</param>
+	static void AppendColor(std::wstring& Out, int Color)
+	{
+		static const wchar_t* Codes[] { L"\x1b[39m", L"\x1b[31m", L"\x1b[32m", L"\x1b[33m", L"\x1b[36m", L"\x1b[90m" };
+
+		Out.append(Codes[Color]);
+	}
+
+	std::vector <Cell> Back {};
+	std::vector <Cell> Front {};
+	int Columns {};
+	int Rows {};
+	bool bInvalid { true };
+};
@@ -0,0 +1,601 @@
+#pragma once
+
+#include <charconv>
+#include <string>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define SERIALIZER_SSE2
+#endif
+
+/// <summary>
+///		Streaming JSON, NDJSON and CSV serializer
+/// </summary>
+class Serializer
+{
+
+public:
+
+	/// <summary>
+	///		Output formats enum
+	/// </summary>
+	enum
+	{
+		eText,
+		eJSON,
+		eNDJSON,
+		eCSV
+	};
+
+	/// <summary>
+	///		Start a new document, the buffer keeps its capacity
+	/// </summary>
+	/// 
+	/// <param name="OutputFormat">Output format</param>
+	/// <param name="CategoriesCount">Number of categories in the document</param>
+	void Begin(int OutputFormat, int CategoriesCount)
+	{
+		Format = OutputFormat;
+		bLongCSV = CategoriesCount > 1;
+		bFirstCategory = true;
+		Buffer.clear();
+
+		switch (Format)
+		{
+		case eJSON:
+		{
+			Buffer.push_back('{');
+		} break;
+
+		case eCSV:
+		{
+			// Several categories don't share columns, so they are written as "category,index,field,value" rows
+			if (bLongCSV)
+			{
+				Buffer.append("category,index,field,value\r\n");
+			}
+		} break;
+		}
+	}
+
+	/// <summary>
+	///		Finish the document
+	/// </summary>
+	void End()
+	{
+		if (Format == eJSON)
+		{
+			Buffer.append("}\n");
+		}
+	}
+
+	/// <summary>
+	///		Start a category
+	/// </summary>
+	/// 
+	/// <param name="Name">Category name</param>
+	/// <param name="IsList">Category has several objects</param>
+	void BeginCategory(const std::wstring& Name, bool IsList)
+	{
+		Category = &Name;
+		bList = IsList;
+		bFirstRecord = true;
+		RecordIndex = 0;
+
+		if (Format == eJSON)
+		{
+			if (!bFirstCategory)
+			{
+				Buffer.push_back(',');
+			}
+
+			WriteJSONString(Name);
+			Buffer.append(bList ? ":[" : ":");
+		}
+
+		bFirstCategory = false;
+	}
+
+	/// <summary>
+	///		Finish a category
+	/// </summary>
+	void EndCategory()
+	{
+		if (Format == eJSON && bList)
+		{
+			Buffer.push_back(']');
+		}
+	}
+
+	/// <summary>
+	///		Start an object
+	/// </summary>
+	void BeginRecord()
+	{
+		bFirstField = true;
+		RecordStart = Buffer.size();
+
+		if (bFirstRecord)
+		{
+			Header.clear();
+		}
+
+		switch (Format)
+		{
+		case eJSON:
+		{
+			if (!bFirstRecord)
+			{
+				Buffer.push_back(',');
+			}
+
+			Buffer.push_back('{');
+		} break;
+
+		case eNDJSON:
+		{
+			Buffer.append("{\"category\":");
+			WriteJSONString(*Category);
+			bFirstField = false;
+		} break;
+		}
+	}
+
+	/// <summary>
+	///		Finish an object
+	/// </summary>
+	void EndRecord()
+	{
+		switch (Format)
+		{
+		case eJSON:
+		{
+			Buffer.push_back('}');
+		} break;
+
+		case eNDJSON:
+		{
+			Buffer.append("}\n");
+		} break;
+
+		case eCSV:
+		{
+			if (bLongCSV)
+			{
+				break;
+			}
+
+			Buffer.append("\r\n");
+
+			// Header row is built while the first row is written and goes in front of it
+			if (bFirstRecord)
+			{
+				Header.append("\r\n");
+				Buffer.insert(RecordStart, Header);
+			}
+		} break;
+		}
+
+		bFirstRecord = false;
+		RecordIndex++;
+	}
+
+	/// <summary>
+	///		Write string field
+	/// </summary>
+	/// 
+	/// <param name="Name">Field name</param>
+	/// <param name="Value">Value</param>
+	void Field(const std::wstring& Name, const std::wstring& Value)
+	{
+		if (BeginField(Name))
+		{
+			WriteJSONString(Value);
+		}
+		else
+		{
+			WriteCSVString(Value);
+			EndField();
+		}
+	}
+
+	/// <summary>
+	///		Write integer field
+	/// </summary>
+	/// 
+	/// <param name="Name">Field name</param>
+	/// <param name="Value">Value</param>
+	void Field(const std::wstring& Name, long long Value)
+	{
+		BeginField(Name);
+		WriteNumber(Value);
+		EndField();
+	}
+
+	/// <summary>
+	///		Write integer field
+	/// </summary>
+	/// 
+	/// <param name="Name">Field name</param>
+	/// <param name="Value">Value</param>
+	void Field(const std::wstring& Name, int Value)
+	{
+		Field(Name, (long long)Value);
+	}
+
+	/// <summary>
+	///		Write integer field
+	/// </summary>
+	/// 
+	/// <param name="Name">Field name</param>
+	/// <param name="Value">Value</param>
+	void Field(const std::wstring& Name, unsigned int Value)
+	{
+		Field(Name, (long long)Value);
+	}
+
+	/// <summary>
+	///		Write floating point field
+	/// </summary>
+	/// 
+	/// <param name="Name">Field name</param>
+	/// <param name="Value">Value</param>
+	void Field(const std::wstring& Name, float Value)
+	{
+		BeginField(Name);
+		WriteNumber(Value);
+		EndField();
+	}
+
+	/// <summary>
+	///		Write boolean field
+	/// </summary>
+	/// 
+	/// <param name="Name">Field name</param>
+	/// <param name="Value">Value</param>
+	void Field(const std::wstring& Name, bool Value)
+	{
+		BeginField(Name);
+		Buffer.append(Value ? "true" : "false");
+		EndField();
+	}
+
+	/// <summary>
+	///		Get serialized document
+	/// </summary>
+	/// 
+	/// <returns>const std::string&</returns>
+	const std::string& GetBuffer() const
+	{
+		return Buffer;
+	}
+
+	/// <summary>
+	///		Append UTF-8 encoded string
+	/// </summary>
+	/// 
+	/// <param name="Output">Output buffer</param>
+	/// <param name="String">Input string</param>
+	static void AppendUTF8(std::string& Output, const std::wstring& String)
+	{
+		EncodeUTF8(Output, String, eNoEscape);
+	}
+
+	/// <summary>
+	///		Append UTF-8 encoded string escaped for JSON string literal
+	/// </summary>
+	/// 
+	/// <param name="Output">Output buffer</param>
+	/// <param name="String">Input string</param>
+	static void AppendJSON(std::string& Output, const std::wstring& String)
+	{
+		EncodeUTF8(Output, String, eJSONEscape);
+	}
+
+private:
+
+	/// <summary>
+	///		String escapes enum
+	/// </summary>
+	enum
+	{
+		eNoEscape,
+		eJSONEscape,
+		eCSVEscape
+	};
+
+	/// <summary>
+	///		Append UTF-8 encoded string, escaping it in the same pass
+	/// </summary>
+	/// 
+	/// <param name="Output">Output buffer</param>
+	/// <param name="String">Input string</param>
+	/// <param name="Escape">Escape type</param>
+	static void EncodeUTF8(std::string& Output, const std::wstring& String, int Escape)
+	{
+		static const char Hex[] { "0123456789abcdef" };
+		size_t Size { Output.size() };
+
+		// Worst case is a 6 bytes "\u00XX" escape or 4 bytes per code unit
+		Output.resize(Size + String.size() * (Escape == eJSONEscape ? 6 : 4));
+		char* Out { &Output[0] + Size };
+
+		for (size_t i = 0; i < String.size(); i++)
+		{
+			// Runs without escapes and non-ASCII characters skip the per-character checks
+			if ((i = CopyPlain(String, i, Out, Escape)) == String.size())
+			{
+				break;
+			}
+
+			unsigned long Code { (unsigned long)String[i] };
+
+			if (Code < 0x80)
+			{
+				if (Escape == eJSONEscape && (Code < 0x20 || Code == '"' || Code == '\\'))
+				{
+					*Out++ = '\\';
+
+					if (Code < 0x20)
+					{
+						*Out++ = 'u';
+						*Out++ = '0';
+						*Out++ = '0';
+						*Out++ = Hex[Code >> 4];
+						*Out++ = Hex[Code & 0xF];
+						continue;
+					}
+				}
+				else if (Escape == eCSVEscape && Code == '"')
+				{
+					*Out++ = '"';
+				}
+
+				*Out++ = (char)Code;
+				continue;
+			}
+
+			// Combine UTF-16 surrogate pair, a lone surrogate becomes U+FFFD
+			if (Code >= 0xD800 && Code <= 0xDFFF)
+			{
+				if (Code <= 0xDBFF && i + 1 < String.size() && String[i + 1] >= 0xDC00 && String[i + 1] <= 0xDFFF)
+				{
+					Code = 0x10000 + ((Code - 0xD800) << 10) + ((unsigned long)String[++i] - 0xDC00);
+				}
+				else
+				{
+					Code = 0xFFFD;
+				}
+			}
+
+			if (Code < 0x800)
+			{
+				*Out++ = (char)(0xC0 | (Code >> 6));
+				*Out++ = (char)(0x80 | (Code & 0x3F));
+			}
+			else if (Code < 0x10000)
+			{
+				*Out++ = (char)(0xE0 | (Code >> 12));
+				*Out++ = (char)(0x80 | ((Code >> 6) & 0x3F));
+				*Out++ = (char)(0x80 | (Code & 0x3F));
+			}
+			else
+			{
+				*Out++ = (char)(0xF0 | (Code >> 18));
+				*Out++ = (char)(0x80 | ((Code >> 12) & 0x3F));
+				*Out++ = (char)(0x80 | ((Code >> 6) & 0x3F));
+				*Out++ = (char)(0x80 | (Code & 0x3F));
+			}
+		}
+
+		Output.resize(Out - &Output[0]);
+	}
+
+	/// <summary>
+	///		Copy ASCII characters which don't need escaping, 16 code units at a time.
+	///		Without SSE2 nothing is copied and the scalar loop converts the whole string
+	/// </summary>
+	/// 
+	/// <param name="String">Input string</param>
+	/// <param name="Start">Run start</param>
+	/// <param name="Out">Output position</param>
+	/// <param name="Escape">Escape type</param>
+	/// 
+	/// <returns>size_t, position of the first code unit left for the scalar loop</returns>
+	static size_t CopyPlain(const std::wstring& String, size_t Start, char*& Out, int Escape)
+	{
+#ifdef SERIALIZER_SSE2
+		for (; Start + 16 <= String.size(); Start += 16, Out += 16)
+		{
+			__m128i Low { Load(String.data() + Start) };
+			__m128i High { Load(String.data() + Start + 8) };
+
+			if (_mm_movemask_epi8(_mm_and_si128(PlainMask(Low, Escape), PlainMask(High, Escape))) != 0xFFFF)
+			{
+				break;
+			}
+
+			// Every code unit is below 0x80, so packing doesn't saturate
+			_mm_storeu_si128((__m128i*)Out, _mm_packus_epi16(Low, High));
+		}
+#endif
+
+		return Start;
+	}
+
+#ifdef SERIALIZER_SSE2
+	/// <summary>
+	///		Load 8 code units as 16-bit lanes, 32-bit code units above 0x7FFF saturate and stay non-ASCII
+	/// </summary>
+	/// 
+	/// <param name="Units">Code units</param>
+	/// 
+	/// <returns>__m128i</returns>
+	static __m128i Load(const wchar_t* Units)
+	{
+		if constexpr (sizeof(wchar_t) == 2)
+		{
+			return _mm_loadu_si128((const __m128i*)Units);
+		}
+		else
+		{
+			return _mm_packs_epi32(_mm_loadu_si128((const __m128i*)Units), _mm_loadu_si128((const __m128i*)(Units + 4)));
+		}
+	}
+
+	/// <summary>
+	///		Get lanes which are copied as is
+	/// </summary>
+	/// 
+	/// <param name="Units">8 code units</param>
+	/// <param name="Escape">Escape type</param>
+	/// 
+	/// <returns>__m128i, all bits of plain lanes are set</returns>
+	static __m128i PlainMask(__m128i Units, int Escape)
+	{
+		__m128i Plain { _mm_cmpeq_epi16(_mm_and_si128(Units, _mm_set1_epi16((short)0xFF80)), _mm_setzero_si128()) };
+
+		if (Escape != eNoEscape)
+		{
+			Plain = _mm_andnot_si128(_mm_cmpeq_epi16(Units, _mm_set1_epi16('"')), Plain);
+		}
+
+		if (Escape == eJSONEscape)
+		{
+			Plain = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi16(Units, _mm_set1_epi16('\\')), _mm_cmplt_epi16(Units, _mm_set1_epi16(0x20))), Plain);
+		}
+
+		return Plain;
+	}
+#endif
+
+	/// <summary>
+	///		Write field prefix
+	/// </summary>
+	/// 
+	/// <param name="Name">Field name</param>
+	/// 
+	/// <returns>bool, true if the value must be written as JSON</returns>
+	bool BeginField(const std::wstring& Name)
+	{
+		if (Format == eCSV)
+		{
+			if (bLongCSV)
+			{
+				WriteCSVString(*Category);
+				Buffer.push_back(',');
+				WriteNumber((long long)RecordIndex);
+				Buffer.push_back(',');
+				WriteCSVString(Name);
+				Buffer.push_back(',');
+			}
+			else
+			{
+				if (!bFirstField)
+				{
+					Buffer.push_back(',');
+				}
+
+				if (bFirstRecord)
+				{
+					if (!bFirstField)
+					{
+						Header.push_back(',');
+					}
+
+					AppendUTF8(Header, Name);
+				}
+			}
+
+			bFirstField = false;
+
+			return false;
+		}
+
+		if (!bFirstField)
+		{
+			Buffer.push_back(',');
+		}
+
+		WriteJSONString(Name);
+		Buffer.push_back(':');
+		bFirstField = false;
+
+		return true;
+	}
+
+	/// <summary>
+	///		Write field suffix
+	/// </summary>
+	void EndField()
+	{
+		if (Format == eCSV && bLongCSV)
+		{
+			Buffer.append("\r\n");
+		}
+	}
+
+	/// <summary>
+	///		Write number
+	/// </summary>
+	/// 
+	/// <typeparam name="T">Type</typeparam>
+	/// <param name="Value">Value</param>
+	template <typename T>
+	void WriteNumber(T Value)
+	{
+		char Number[32] {};
+		auto Result { std::to_chars(Number, Number + sizeof(Number), Value) };
+
+		Buffer.append(Number, Result.ptr);
+	}
+
+	/// <summary>
+	///		Write JSON string with escapes
+	/// </summary>
+	/// 
+	/// <param name="String">Input string</param>
+	void WriteJSONString(const std::wstring& String)
+	{
+		Buffer.push_back('"');
+		EncodeUTF8(Buffer, String, eJSONEscape);
+		Buffer.push_back('"');
+	}
+
+	/// <summary>
+	///		Write CSV field, quoted only when it contains separators, quotes or line breaks (RFC 4180)
+	/// </summary>
+	/// 
+	/// <param name="String">Input string</param>
+	void WriteCSVString(const std::wstring& String)
+	{
+		bool bQuote { false };
+
+		for (size_t i = 0; i < String.size() && !bQuote; i++)
+		{
+			bQuote = String[i] == L',' || String[i] == L'"' || String[i] == L'\r' || String[i] == L'\n';
+		}
+
+		if (!bQuote)
+		{
+			EncodeUTF8(Buffer, String, eNoEscape);
+			return;
+		}
+
+		Buffer.push_back('"');
+		EncodeUTF8(Buffer, String, eCSVEscape);
+		Buffer.push_back('"');
+	}
+
+	std::string Buffer {};
+	std::string Header {};
+	const std::wstring* Category {};
+	size_t RecordStart {};
+	int RecordIndex {};
+	int Format {};
+	bool bLongCSV {};
+	bool bList {};
+	bool bFirstCategory {};
+	bool bFirstRecord {};
+	bool bFirstField {};
+};
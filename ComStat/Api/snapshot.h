@@ -0,0 +1,246 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <string>
+#include <windows.h>
+
+#define SNAPSHOT_NAME L"Local\\ComStatSnapshot"
+#define SNAPSHOT_MAGIC 0x54534D43
+#define SNAPSHOT_VERSION 2
+#define SNAPSHOT_MAX_DRIVES 32
+#define SNAPSHOT_INVENTORY_SIZE 65536
+#define SNAPSHOT_READ_RETRIES 1000
+
+/// <summary>
+///		Latest load sample published in shared memory
+/// </summary>
+struct SnapshotSample
+{
+	long long Timestamp {};
+	float CPULoad {};
+	float MemoryLoad {};
+	unsigned int DriveCount {};
+
+	struct
+	{
+		wchar_t DriveLetter[4] {};
+		float FreeSpace {};
+	} Drives[SNAPSHOT_MAX_DRIVES] {};
+};
+
+/// <summary>
+///		Shared memory layout, Sequence is odd while the publisher writes (seqlock).
+///		InventoryRequired is the size of the whole document, the inventory isn't published if it exceeds SNAPSHOT_INVENTORY_SIZE
+/// </summary>
+struct SnapshotLayout
+{
+	unsigned int Magic {};
+	unsigned int Version {};
+	std::atomic <unsigned int> Sequence {};
+	SnapshotSample Sample {};
+	unsigned int InventorySize {};
+	unsigned int InventoryRequired {};
+	char Inventory[SNAPSHOT_INVENTORY_SIZE] {};
+};
+
+/// <summary>
+///		Publishes samples and inventory (UTF-8 JSON) into named shared memory
+/// </summary>
+class SnapshotPublisher
+{
+
+public:
+
+	/// <summary>
+	///		Destructor
+	/// </summary>
+	~SnapshotPublisher()
+	{
+		Close();
+	}
+
+	/// <summary>
+	///		Create shared memory segment
+	/// </summary>
+	/// 
+	/// <returns>bool</returns>
+	bool Open()
+	{
+		Mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, sizeof(SnapshotLayout), SNAPSHOT_NAME);
+
+		if (!Mapping)
+		{
+			return false;
+		}
+
+		Layout = (SnapshotLayout*)MapViewOfFile(Mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(SnapshotLayout));
+
+		if (!Layout)
+		{
+			Close();
+			return false;
+		}
+
+		Layout->Magic = SNAPSHOT_MAGIC;
+		Layout->Version = SNAPSHOT_VERSION;
+
+		return true;
+	}
+
+	/// <summary>
+	///		Unmap and close shared memory segment
+	/// </summary>
+	void Close()
+	{
+		if (Layout)
+		{
+			UnmapViewOfFile(Layout);
+			Layout = nullptr;
+		}
+
+		if (Mapping)
+		{
+			CloseHandle(Mapping);
+			Mapping = nullptr;
+		}
+	}
+
+	/// <summary>
+	///		Publish sample, inventory is published only if it isn't nullptr.
+	///		Inventory which doesn't fit isn't cut, invalid JSON would be published, readers get its size instead
+	/// </summary>
+	/// 
+	/// <param name="Sample">Sample</param>
+	/// <param name="Inventory">Inventory document</param>
+	/// 
+	/// <returns>bool, false if the inventory exceeds SNAPSHOT_INVENTORY_SIZE</returns>
+	bool Publish(const SnapshotSample& Sample, const std::string* Inventory = nullptr)
+	{
+		bool bFits { !Inventory || Inventory->size() <= SNAPSHOT_INVENTORY_SIZE };
+		unsigned int Sequence { Layout->Sequence.load(std::memory_order_relaxed) };
+
+		Layout->Sequence.store(Sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		Layout->Sample = Sample;
+
+		if (Inventory)
+		{
+			Layout->InventoryRequired = (unsigned int)std::min(Inventory->size(), (size_t)UINT_MAX);
+			Layout->InventorySize = bFits ? (unsigned int)Inventory->size() : 0;
+			memcpy(Layout->Inventory, Inventory->data(), Layout->InventorySize);
+		}
+
+		Layout->Sequence.store(Sequence + 2, std::memory_order_release);
+
+		return bFits;
+	}
+
+private:
+
+	HANDLE Mapping {};
+	SnapshotLayout* Layout {};
+};
+
+/// <summary>
+///		Reads consistent snapshots without locks or system calls after Open, e.g.
+///		SnapshotReader Reader {}; SnapshotSample Sample {}; if (Reader.Open() && Reader.Read(Sample)) { ... }
+/// </summary>
+class SnapshotReader
+{
+
+public:
+
+	/// <summary>
+	///		Destructor
+	/// </summary>
+	~SnapshotReader()
+	{
+		if (Layout)
+		{
+			UnmapViewOfFile(Layout);
+		}
+
+		if (Mapping)
+		{
+			CloseHandle(Mapping);
+		}
+	}
+
+	/// <summary>
+	///		Map shared memory segment created by publisher
+	/// </summary>
+	/// 
+	/// <returns>bool</returns>
+	bool Open()
+	{
+		Mapping = OpenFileMappingW(FILE_MAP_READ, FALSE, SNAPSHOT_NAME);
+
+		if (!Mapping)
+		{
+			return false;
+		}
+
+		Layout = (const SnapshotLayout*)MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, sizeof(SnapshotLayout));
+
+		return Layout && Layout->Magic == SNAPSHOT_MAGIC && Layout->Version == SNAPSHOT_VERSION;
+	}
+
+	/// <summary>
+	///		Copy the latest sample and optionally inventory, retries while publisher writes.
+	///		Inventory is empty if it didn't fit in shared memory, Required tells its size then
+	/// </summary>
+	/// 
+	/// <param name="Sample">Sample</param>
+	/// <param name="Inventory">Inventory document, nullptr if not needed</param>
+	/// <param name="Required">Inventory document size, it exceeds SNAPSHOT_INVENTORY_SIZE if the inventory wasn't published</param>
+	/// 
+	/// <returns>bool, false if nothing was published yet or publisher stopped while writing</returns>
+	bool Read(SnapshotSample& Sample, std::string* Inventory = nullptr, unsigned int* Required = nullptr) const
+	{
+		for (int i = 0; i < SNAPSHOT_READ_RETRIES; i++)
+		{
+			unsigned int Before { Layout->Sequence.load(std::memory_order_acquire) };
+
+			if (!Before)
+			{
+				return false;
+			}
+
+			if (Before & 1)
+			{
+				YieldProcessor();
+				continue;
+			}
+
+			Sample = Layout->Sample;
+
+			if (Inventory)
+			{
+				Inventory->assign(Layout->Inventory, std::min(Layout->InventorySize, (unsigned int)SNAPSHOT_INVENTORY_SIZE));
+			}
+
+			if (Required)
+			{
+				*Required = Layout->InventoryRequired;
+			}
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			if (Layout->Sequence.load(std::memory_order_relaxed) == Before)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+private:
+
+	HANDLE Mapping {};
+	const SnapshotLayout* Layout {};
+};
@@ -0,0 +1,267 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../Api/serializer.h"
+
+#define TRACE_BUFFER_EVENTS 1024
+
+/// <summary>
+///		Scoped trace spans of collectors, queries and I/O calls, exported as Chrome trace-event JSON.
+///		Every thread records into its own buffer, disabled spans cost one atomic load
+/// </summary>
+namespace Trace
+{
+	/// <summary>
+	///		Completed span, times are nanoseconds since tracing started, async spans have a non-zero id
+	/// </summary>
+	struct Event
+	{
+		const char* Name {};
+		const char* Category {};
+		std::wstring Detail {};
+		long long Start {};
+		long long Duration {};
+		unsigned long long Id {};
+	};
+
+	/// <summary>
+	///		Thread events, the mutex is taken by the owner thread only, unless the trace is being written
+	/// </summary>
+	struct Buffer
+	{
+		unsigned int ThreadId {};
+		std::mutex Mutex {};
+		std::vector <Event> Events {};
+	};
+
+	inline std::atomic <bool> bEnabled {};
+	inline std::atomic <unsigned long long> NextId {};
+	inline std::chrono::steady_clock::time_point Origin {};
+	inline std::mutex Mutex {};
+	inline std::vector <std::shared_ptr <Buffer>> Buffers {};
+
+	/// <summary>
+	///		Get buffer of the calling thread, it's registered on first use and outlives the thread
+	/// </summary>
+	/// 
+	/// <returns>Buffer&</returns>
+	inline Buffer& LocalBuffer()
+	{
+		thread_local std::shared_ptr <Buffer> Local {};
+
+		if (!Local)
+		{
+			std::lock_guard <std::mutex> Lock(Mutex);
+
+			Local = std::make_shared <Buffer>();
+			Local->ThreadId = (unsigned int)Buffers.size();
+			Local->Events.reserve(TRACE_BUFFER_EVENTS);
+			Buffers.push_back(Local);
+		}
+
+		return *Local;
+	}
+
+	/// <summary>
+	///		Get time since tracing started
+	/// </summary>
+	/// 
+	/// <returns>long long, nanoseconds</returns>
+	inline long long Now()
+	{
+		return std::chrono::duration_cast <std::chrono::nanoseconds>(std::chrono::steady_clock::now() - Origin).count();
+	}
+
+	/// <summary>
+	///		Start recording, events recorded since the previous start are kept if tracing is already enabled
+	/// </summary>
+	inline void Start()
+	{
+		if (bEnabled.load(std::memory_order_relaxed))
+		{
+			return;
+		}
+
+		{
+			std::lock_guard <std::mutex> Lock(Mutex);
+
+			for (auto& Thread : Buffers)
+			{
+				std::lock_guard <std::mutex> ThreadLock(Thread->Mutex);
+				Thread->Events.clear();
+			}
+
+			Origin = std::chrono::steady_clock::now();
+		}
+
+		bEnabled.store(true, std::memory_order_release);
+	}
+
+	/// <summary>
+	///		Stop recording and write trace-event JSON, it opens in chrome://tracing or Perfetto
+	/// </summary>
+	/// 
+	/// <param name="Path">File</param>
+	/// 
+	/// <returns>bool</returns>
+	inline bool Write(const std::wstring& Path)
+	{
+		std::string Text { "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"ComStat\"}}" };
+		char Number[96] {};
+
+		bEnabled.store(false, std::memory_order_relaxed);
+
+		std::lock_guard <std::mutex> Lock(Mutex);
+
+		for (auto& Thread : Buffers)
+		{
+			std::lock_guard <std::mutex> ThreadLock(Thread->Mutex);
+
+			for (auto& Recorded : Thread->Events)
+			{
+				Text.append(",\n{\"name\":\"").append(Recorded.Name).append("\",\"cat\":\"").append(Recorded.Category).append(Recorded.Id ? "\",\"ph\":\"b\"" : "\",\"ph\":\"X\"");
+
+				// Microseconds with nanosecond precision, async span is a pair of begin and end events with the same id
+				if (Recorded.Id)
+				{
+					snprintf(Number, sizeof(Number), ",\"id\":%llu,\"ts\":%lld.%03lld,\"pid\":1,\"tid\":%u",
+						Recorded.Id, Recorded.Start / 1000, Recorded.Start % 1000, Thread->ThreadId);
+				}
+				else
+				{
+					snprintf(Number, sizeof(Number), ",\"ts\":%lld.%03lld,\"dur\":%lld.%03lld,\"pid\":1,\"tid\":%u",
+						Recorded.Start / 1000, Recorded.Start % 1000, Recorded.Duration / 1000, Recorded.Duration % 1000, Thread->ThreadId);
+				}
+
+				Text.append(Number);
+
+				if (Recorded.Detail.size())
+				{
+					Text.append(",\"args\":{\"detail\":\"");
+					Serializer::AppendJSON(Text, Recorded.Detail);
+					Text.append("\"}");
+				}
+
+				Text.append("}");
+
+				if (Recorded.Id)
+				{
+					long long End { Recorded.Start + Recorded.Duration };
+
+					Text.append(",\n{\"name\":\"").append(Recorded.Name).append("\",\"cat\":\"").append(Recorded.Category).append("\",\"ph\":\"e\"");
+					snprintf(Number, sizeof(Number), ",\"id\":%llu,\"ts\":%lld.%03lld,\"pid\":1,\"tid\":%u}",
+						Recorded.Id, End / 1000, End % 1000, Thread->ThreadId);
+					Text.append(Number);
+				}
+			}
+		}
+
+		Text.append("\n]}\n");
+
+		std::ofstream File(std::filesystem::path(Path), std::ios::out | std::ios::trunc | std::ios::binary);
+
+		File.write(Text.data(), Text.size());
+		File.close();
+
+		return !File.fail();
+	}
+
+	/// <summary>
+	///		Scoped span, it's recorded when it goes out of scope
+	/// </summary>
+	class Span
+	{
+
+	public:
+
+		/// <summary>
+		///		Constructor
+		/// </summary>
+		/// 
+		/// <param name="Name">Span name, string literal</param>
+		/// <param name="Category">Span category, string literal</param>
+		/// <param name="Detail">Detail, e.g. WMI class, it's copied only when tracing is enabled</param>
+		/// <param name="SubDetail">Detail suffix, it's appended after a dot</param>
+		Span(const char* Name, const char* Category, std::wstring_view Detail = {}, std::wstring_view SubDetail = {})
+		{
+			if (!bEnabled.load(std::memory_order_acquire))
+			{
+				return;
+			}
+
+			Recorded.Name = Name;
+			Recorded.Category = Category;
+			Recorded.Detail.assign(Detail);
+
+			if (SubDetail.size())
+			{
+				Recorded.Detail.append(L".").append(SubDetail);
+			}
+
+			bActive = true;
+			Recorded.Start = Now();
+		}
+
+		/// <summary>
+		///		Destructor
+		/// </summary>
+		~Span()
+		{
+			if (!bActive || !bEnabled.load(std::memory_order_relaxed))
+			{
+				return;
+			}
+
+			Recorded.Duration = Now() - Recorded.Start;
+
+			Buffer& Thread { LocalBuffer() };
+			std::lock_guard <std::mutex> Lock(Thread.Mutex);
+
+			Thread.Events.push_back(std::move(Recorded));
+		}
+
+		Span(const Span&) = delete;
+		Span& operator=(const Span&) = delete;
+
+	protected:
+
+		Event Recorded {};
+		bool bActive {};
+	};
+
+	/// <summary>
+	///		Span of a coroutine which suspends inside it, it's written as async begin and end events with its own id,
+	///		so spans interleaved on the loop thread don't overlap each other
+	/// </summary>
+	class AsyncSpan : public Span
+	{
+
+	public:
+
+		/// <summary>
+		///		Constructor
+		/// </summary>
+		/// 
+		/// <param name="Name">Span name, string literal</param>
+		/// <param name="Category">Span category, string literal</param>
+		/// <param name="Detail">Detail, e.g. WMI class, it's copied only when tracing is enabled</param>
+		/// <param name="SubDetail">Detail suffix, it's appended after a dot</param>
+		AsyncSpan(const char* Name, const char* Category, std::wstring_view Detail = {}, std::wstring_view SubDetail = {})
+			: Span(Name, Category, Detail, SubDetail)
+		{
+			if (bActive)
+			{
+				Recorded.Id = NextId.fetch_add(1, std::memory_order_relaxed) + 1;
+			}
+		}
+	};
+}
@@ -0,0 +1,651 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+#include "../Api/compress.h"
+#include "../Api/diff.h"
+#include "../Api/dump.h"
+#include "../Api/fields.h"
+#include "../Api/intern.h"
+#include "../Api/parser.h"
+#include "../Api/query.h"
+#include "../Api/report.h"
+#include "../Api/screen.h"
+#include "../Api/serializer.h"
+
+#define BENCH_RESULTS_FILE "bench_results.json"
+#define BENCH_MIN_TIME 0.2
+
+#ifdef _WIN32
+#define BENCH_NULL_DEVICE "NUL"
+#else
+#define BENCH_NULL_DEVICE "/dev/null"
+#endif
+
+// Replaced deallocation isn't inlined, otherwise GCC sees free of a pointer returned by operator new and warns
+#if defined(__GNUC__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#else
+#define BENCH_NOINLINE
+#endif
+
+// Every heap allocation of the process is counted, benchmarks report the difference per operation
+std::atomic <unsigned long long> Allocations {};
+
+void* operator new(size_t Size)
+{
+	Allocations.fetch_add(1, std::memory_order_relaxed);
+
+	if (void* Memory = malloc(Size ? Size : 1))
+	{
+		return Memory;
+	}
+
+	throw std::bad_alloc();
+}
+
+BENCH_NOINLINE void operator delete(void* Memory) noexcept
+{
+	free(Memory);
+}
+
+BENCH_NOINLINE void operator delete(void* Memory, size_t) noexcept
+{
+	free(Memory);
+}
+
+/// <summary>
+///		Microbenchmarks of command parsing, formatting, saving, serialization and disk matching on synthetic inventories
+/// </summary>
+namespace Bench
+{
+	/// <summary>
+	///		Benchmark result
+	/// </summary>
+	struct Result
+	{
+		std::string Name {};
+		std::string Inventory {};
+		unsigned long long Iterations {};
+		double NanosecondsPerOp {};
+		double AllocationsPerOp {};
+		double BytesPerOp {};
+	};
+
+	std::vector <Result> Results {};
+
+	/// <summary>
+	///		Synthetic inventory size
+	/// </summary>
+	struct Shape
+	{
+		const char* Name {};
+		int Disks {};
+		int GPUs {};
+		int Adapters {};
+	};
+
+	/// <summary>
+	///		Create inventory, some disk models are non-ASCII, so UTF-8 encoding takes the scalar path too
+	/// </summary>
+	/// 
+	/// <param name="Size">Inventory size</param>
+	/// 
+	/// <returns>ComputerStatistics</returns>
+	ComputerStatistics CreateInventory(const Shape& Size)
+	{
+		ComputerStatistics Statistics { ComputerStatistics::eQueryNone };
+		std::mt19937 Random { 42 };
+
+		for (int i = 0; i < Size.Disks; i++)
+		{
+			auto& Disk { Statistics.Disk.emplace_back() };
+
+			Disk.SerialNumber = L"S4EWNX0R" + std::to_wstring(100000 + i);
+			Disk.Model = i % 4 == 3 ? L"Samsung SSD 970 EVO Plus 1TB \u2014 \u0436\u0451\u0441\u0442\u043A\u0438\u0439 \U0001F4BE" : L"Samsung SSD 970 EVO Plus 1TB";
+			Disk.Interface = i % 2 ? L"SCSI" : L"NVMe";
+			Disk.DriveLetter = std::wstring(1, (wchar_t)(L'C' + i % 24)) + L":";
+			Disk.Size = 256 << (Random() % 4);
+			Disk.FreeSpace = Random() % Disk.Size;
+			Disk.MediaType = i % 3 ? 4 : 3;
+			Disk.IsBootDrive = !i;
+		}
+
+		for (int i = 0; i < Size.GPUs; i++)
+		{
+			auto& GPU { Statistics.GPU.emplace_back() };
+
+			GPU.Name = L"NVIDIA GeForce RTX 30" + std::to_wstring(60 + i * 10);
+			GPU.DriverVersion = L"31.0.15.5176";
+			GPU.XResolution = 2560;
+			GPU.YResolution = 1440;
+			GPU.RefreshRate = 144;
+		}
+
+		for (int i = 0; i < Size.Adapters; i++)
+		{
+			auto& Adapter { Statistics.NetworkAdapter.emplace_back() };
+			wchar_t MAC[32] {};
+
+			swprintf(MAC, 32, L"00:1A:2B:3C:%02X:%02X", i >> 8 & 0xFF, i & 0xFF);
+			Adapter.Name = L"Intel(R) Ethernet Controller I225-V #" + std::to_wstring(i);
+			Adapter.MAC = MAC;
+		}
+
+		Statistics.SMBIOS = { L"ASUSTeK COMPUTER INC.", L"ROG STRIX Z690-A GAMING WIFI D4", L"Rev 1.xx", L"210685750200317" };
+		Statistics.CPU = { L"BFEBFBFF00090672", L"GenuineIntel", L"12th Gen Intel(R) Core(TM) i7-12700K", 12, 20 };
+		Statistics.System = { L"WORKSTATION-01", false, L"10.0.22631", L"Microsoft Windows 11 Pro", L"64-bit", L"00330-80000-00000-AA123" };
+		Statistics.PhysicalMemory = { L"F4-3600C16-16GVKC", 32542.f, 18411.f, 131072.f, 131006.f, 37406.f, 19884.f };
+		Statistics.Registry = { L"{5c1b0b2a-31d5-5d3b-8b7d-6b1e0d5f0c3a}", L"ASUS", L"System Product Name" };
+
+		return Statistics;
+	}
+
+	/// <summary>
+	///		Run operation until minimum time passes and record time and allocations per operation
+	/// </summary>
+	/// 
+	/// <param name="Name">Benchmark name</param>
+	/// <param name="Inventory">Inventory name</param>
+	/// <param name="Operation">Operation, returns number of processed bytes, 0 if throughput isn't measured in bytes</param>
+	void Run(const char* Name, const char* Inventory, const std::function<size_t()>& Operation)
+	{
+		using Clock = std::chrono::steady_clock;
+
+		// Warm up, so buffers reach their steady capacity
+		size_t Bytes { Operation() };
+		unsigned long long Iterations { 1 };
+		double Seconds {};
+		unsigned long long AllocationsBefore {};
+
+		for (;;)
+		{
+			AllocationsBefore = Allocations.load();
+			auto Start { Clock::now() };
+
+			for (unsigned long long i = 0; i < Iterations; i++)
+			{
+				Operation();
+			}
+
+			Seconds = std::chrono::duration <double>(Clock::now() - Start).count();
+
+			if (Seconds >= BENCH_MIN_TIME)
+			{
+				break;
+			}
+
+			Iterations *= Seconds > BENCH_MIN_TIME / 10 ? 2 : 10;
+		}
+
+		Result Measured { Name, Inventory, Iterations, Seconds * 1e9 / Iterations, (double)(Allocations.load() - AllocationsBefore) / Iterations, (double)Bytes };
+
+		printf("%-14s %-7s %12.1f ns/op %8.2f allocs/op %12.0f ops/s", Name, Inventory, Measured.NanosecondsPerOp, Measured.AllocationsPerOp, 1e9 / Measured.NanosecondsPerOp);
+
+		if (Bytes)
+		{
+			printf(" %10.1f MB/s", Measured.BytesPerOp / Measured.NanosecondsPerOp * 1e9 / 1048576);
+		}
+
+		printf("\n");
+
+		Results.push_back(Measured);
+	}
+
+	/// <summary>
+	///		Parse category command, clauses are parsed by the console code
+	/// </summary>
+	/// 
+	/// <param name="Command">Command</param>
+	/// <param name="Commands">Commands table</param>
+	/// <param name="SubCommands">Sub commands tables</param>
+	/// <param name="Filter">Query</param>
+	/// <param name="SubCommandIndex">Sub commands</param>
+	/// 
+	/// <returns>bool</returns>
+	bool ParseCommand(std::wstring_view Command, const KeywordTable <32>& Commands, const std::vector <KeywordTable <16>>& SubCommands, Query& Filter, std::vector <int>& SubCommandIndex)
+	{
+		Tokenizer Tokens { Command };
+		std::wstring_view Token {};
+		int CategoryIndex {};
+
+		Filter.Clear();
+		SubCommandIndex.clear();
+
+		if (!Tokens.Next(Token) || !(CategoryIndex = Commands.Find(Token)) || !Tokens.Next(Token))
+		{
+			return false;
+		}
+
+		return Report::ParseQuery(Tokens, Token, Fields::Categories.at(CategoryIndex - 1), SubCommands.at(CategoryIndex - 1), Filter, SubCommandIndex);
+	}
+
+	/// <summary>
+	///		Run all benchmarks on one inventory
+	/// </summary>
+	/// 
+	/// <param name="Size">Inventory size</param>
+	void RunInventory(const Shape& Size)
+	{
+		ComputerStatistics Statistics { CreateInventory(Size) };
+		std::vector <std::wstring> CategoryNames { L"invalid" };
+		std::vector <KeywordTable <16>> SubCommands(Fields::Categories.size());
+		std::wstring FieldText {};
+		std::wstring Screen {};
+		std::string SaveText {};
+		std::vector <size_t> Rows {};
+		std::vector <int> SubCommandIndex {};
+		Query Filter {};
+		Serializer Output {};
+
+		for (size_t i = 0; i < Fields::Categories.size(); i++)
+		{
+			CategoryNames.push_back(Fields::Categories.at(i).Name);
+
+			for (size_t j = 0; j < Fields::Categories.at(i).Fields.size(); j++)
+			{
+				SubCommands.at(i).Add(Fields::Categories.at(i).Fields.at(j).Name, (int)j + 1);
+			}
+		}
+
+		KeywordTable <32> Commands { CategoryNames };
+		std::wstring Command { L"disk get model size freespace where freespace < 500 and interface = \"NVMe\" order by size desc" };
+
+		Run("parse", Size.Name, [&]() {
+			ParseCommand(Command, Commands, SubCommands, Filter, SubCommandIndex);
+			return Command.size() * sizeof(wchar_t);
+		});
+
+		// Filter of the last parsed command
+		Run("select", Size.Name, [&]() {
+			Filter.Select(Fields::Categories.front(), Statistics, Rows);
+			return (size_t)0;
+		});
+
+		Filter.Clear();
+
+		// PrintCategory of every category, console output is replaced by a buffer
+		Run("print", Size.Name, [&]() {
+			Screen.clear();
+
+			for (auto& Category : Fields::Categories)
+			{
+				size_t Column { Fields::LabelColumn(Category) };
+
+				Filter.Select(Category, Statistics, Rows);
+
+				for (size_t i = 0; i < Rows.size(); i++)
+				{
+					Report::AppendRecord(Category, Category.Record(Statistics, Rows.at(i)), Column, Screen, FieldText);
+
+					if (i + 1 < Rows.size())
+					{
+						Screen.push_back(L'\n');
+					}
+				}
+			}
+
+			return Screen.size() * sizeof(wchar_t);
+		});
+
+		// "save" dump without writing the file
+		auto Save { [&]() {
+			SaveText.assign("\nSaved time: Mon Jan  1 00:00:00 2024\n");
+
+			for (auto& Category : Fields::Categories)
+			{
+				SaveText.append("\n--------------------------\n");
+				Serializer::AppendUTF8(SaveText, Report::CategoryTitle(Category, L' '));
+				SaveText.append("\n--------------------------\n\n");
+
+				Filter.Select(Category, Statistics, Rows);
+
+				for (size_t i = 0; i < Rows.size(); i++)
+				{
+					Report::SaveRecord(Category, Category.Record(Statistics, Rows.at(i)), SaveText, FieldText);
+
+					if (i + 1 < Rows.size())
+					{
+						SaveText.push_back('\n');
+					}
+				}
+			}
+
+			return SaveText.size();
+		} };
+
+		Run("save", Size.Name, Save);
+
+		Run("json", Size.Name, [&]() {
+			Output.Begin(Serializer::eJSON, (int)Fields::Categories.size());
+
+			for (auto& Category : Fields::Categories)
+			{
+				Output.BeginCategory(Category.Name, Category.IsList);
+
+				for (size_t i = 0; i < Category.Count(Statistics); i++)
+				{
+					Report::SerializeRecord(Output, Category, Category.Record(Statistics, i), {}, FieldText);
+				}
+
+				Output.EndCategory();
+			}
+
+			Output.End();
+
+			return Output.GetBuffer().size();
+		});
+
+		// Two dumps of the same inventory, the second one is saved again after free space and GPU drivers changed,
+		// free space is volatile, so only drivers are reported
+		std::string Dumps { SaveText };
+
+		for (auto& Disk : Statistics.Disk)
+		{
+			Disk.FreeSpace++;
+		}
+
+		for (auto& GPU : Statistics.GPU)
+		{
+			GPU.DriverVersion = L"32.0.15.6094";
+		}
+
+		Save();
+		Dumps += SaveText;
+
+		Run("dump-parse", Size.Name, [&]() {
+			InventoryDump Dump {};
+
+			Dump.Parse(Dumps, 0);
+
+			return Dumps.size() / 2;
+		});
+
+		InventoryDump Before {};
+		InventoryDump After {};
+		InventoryDiff Diff {};
+		std::vector <InventoryDiff::Change> Changes {};
+
+		Before.Parse(Dumps, 1);
+		After.Parse(Dumps, 0);
+
+		Run("diff", Size.Name, [&]() {
+			Diff.Compare(Before, After, Changes);
+			return Dumps.size();
+		});
+
+		std::string Compressed {};
+		std::string Decompressed {};
+
+		Run("compress", Size.Name, [&]() {
+			Compressed.clear();
+
+			for (size_t i = 0; i < Dumps.size(); i += COMPRESSION_BLOCK_SIZE)
+			{
+				BlockCompression::AppendBlock(std::string_view(Dumps).substr(i, COMPRESSION_BLOCK_SIZE), Compressed);
+			}
+
+			return Dumps.size();
+		});
+
+		Run("decompress", Size.Name, [&]() {
+			Decompressed.clear();
+			BlockCompression::DecompressBlocks(Compressed, Decompressed);
+			return Decompressed.size();
+		});
+
+		StringPool <wchar_t> Pool {};
+
+		Run("intern", Size.Name, [&]() {
+			InternedSnapshot Snapshot { Statistics, Pool };
+			return (size_t)0;
+		});
+
+		// Hot-plug refresh check of serve and publish, the inventory is the same apart from volatile fields
+		InternedSnapshot Served { Statistics, Pool };
+		bool bSame {};
+
+		Run("intern-compare", Size.Name, [&]() {
+			InternedSnapshot Refreshed { Statistics, Pool };
+			bSame = Refreshed.IsSameInventory(Served);
+			return (size_t)0;
+		});
+
+		// Disk and volume matching of QueryDisk, volumes are listed in a different order than disks.
+		// Every fourth disk also holds the first extent of a volume spanning it and the next disk, it's listed first
+		std::vector <std::wstring> DiskNames {};
+		std::vector <std::wstring> VolumeNames {};
+		std::vector <const wchar_t*> DiskName {};
+		std::vector <const wchar_t*> DeviceId {};
+		std::vector <const wchar_t*> SortedDeviceId {};
+		std::vector <int> VolumeDisk {};
+
+		for (int i = 0; i < Size.Disks; i++)
+		{
+			if (i % 4 == 3)
+			{
+				VolumeNames.push_back(L"Z" + std::to_wstring(i) + L":");
+				VolumeDisk.push_back(Size.Disks - 1 - i);
+			}
+		}
+
+		for (int i = 0; i < Size.Disks; i++)
+		{
+			DiskNames.push_back(L"\\\\.\\PHYSICALDRIVE" + std::to_wstring(i));
+			VolumeNames.push_back(Statistics.Disk.at(i).DriveLetter);
+			VolumeDisk.push_back(Size.Disks - 1 - i);
+		}
+
+		for (int i = 0; i < Size.Disks; i++)
+		{
+			DiskName.push_back(DiskNames.at(i).c_str());
+		}
+
+		for (auto& Volume : VolumeNames)
+		{
+			DeviceId.push_back(Volume.c_str());
+		}
+
+		Run("match-volumes", Size.Name, [&]() {
+			SortedDeviceId.assign(DiskName.size(), nullptr);
+			ComputerStatistics::MatchVolumes(DiskName, VolumeDisk, DeviceId, SortedDeviceId);
+			return (size_t)0;
+		});
+	}
+
+	/// <summary>
+	///		Run console output benchmarks, "all" response is written to the null device with std::endl after every line,
+	///		as the console used to do, and as one buffered write per response, as ConsoleOutput does
+	/// </summary>
+	/// 
+	/// <param name="Size">Inventory size</param>
+	void RunOutput(const Shape& Size)
+	{
+		ComputerStatistics Statistics { CreateInventory(Size) };
+		std::ofstream Sink(BENCH_NULL_DEVICE, std::ios::out | std::ios::binary);
+		std::wstring FieldText {};
+		std::wstring Text {};
+		std::string Line {};
+		std::string Bytes {};
+		std::vector <size_t> Rows {};
+		Query Filter {};
+
+		Run("output-endl", Size.Name, [&]() {
+			size_t Written {};
+
+			for (auto& Category : Fields::Categories)
+			{
+				size_t Column { Fields::LabelColumn(Category) };
+
+				Filter.Select(Category, Statistics, Rows);
+
+				for (size_t Row : Rows)
+				{
+					const void* Record { Category.Record(Statistics, Row) };
+
+					for (auto& Field : Category.Fields)
+					{
+						Line.clear();
+						Serializer::AppendUTF8(Line, Field.Label);
+						Line.push_back(':');
+
+						for (size_t Position = (Field.Label.size() + 1) / 8 * 8; Position < Column; Position += 8)
+						{
+							Line.push_back('\t');
+						}
+
+						Serializer::AppendUTF8(Line, Report::FormatField(Field, Record, FieldText));
+						Sink << Line << std::endl;
+						Written += Line.size() + 1;
+					}
+				}
+			}
+
+			return Written;
+		});
+
+		Run("output-buffer", Size.Name, [&]() {
+			Text.clear();
+
+			for (auto& Category : Fields::Categories)
+			{
+				size_t Column { Fields::LabelColumn(Category) };
+
+				Filter.Select(Category, Statistics, Rows);
+
+				for (size_t Row : Rows)
+				{
+					Report::AppendRecord(Category, Category.Record(Statistics, Row), Column, Text, FieldText);
+				}
+			}
+
+			Bytes.clear();
+			Serializer::AppendUTF8(Bytes, Text);
+			Sink.write(Bytes.data(), Bytes.size());
+			Sink.flush();
+
+			return Bytes.size();
+		});
+	}
+
+	/// <summary>
+	///		Run dashboard frame benchmarks, bytes are escape sequences written per frame
+	/// </summary>
+	void RunScreen()
+	{
+		ScreenBuffer Screen {};
+		std::wstring Frame {};
+		std::vector <float> Loads(64, 50.0f);
+		wchar_t Text[64] {};
+		std::mt19937 Random { 7 };
+		std::uniform_real_distribution <float> Step { -5.0f, 5.0f };
+
+		Screen.Resize(120, 40);
+
+		// Layout of the realtime dashboard: 64 cores in three columns, memory, disks and network
+		auto Draw { [&]() {
+			Screen.Clear();
+			Screen.Text(0, 0, L"ComStat realtime 12:00:00", ScreenBuffer::eCyan);
+
+			for (size_t i = 0; i < Loads.size(); i++)
+			{
+				int Row { 2 + (int)i / 3 };
+				int Column { (int)(i % 3) * 40 };
+				int Length { swprintf(Text, sizeof(Text) / sizeof(Text[0]), L"  Core %-3zu%5.1f%% ", i, Loads.at(i)) };
+
+				Screen.Bar(Screen.Text(Column, Row, std::wstring_view(Text, Length)), Row, 22, Loads.at(i));
+			}
+
+			for (int Row = 26; Row < 38; Row++)
+			{
+				Screen.Text(2, Row, L"Ethernet    down    1024.0 KB/s  up      12.5 KB/s");
+			}
+
+			Frame.clear();
+			Screen.Render(Frame);
+
+			return Frame.size() * sizeof(wchar_t);
+		} };
+
+		Run("screen-full", "120x40", [&]() {
+			Screen.Invalidate();
+			return Draw();
+		});
+
+		// A tenth of a second changes load of a few cores
+		Run("screen-diff", "120x40", [&]() {
+			for (int i = 0; i < 8; i++)
+			{
+				float& Load { Loads.at(Random() % Loads.size()) };
+				Load = std::clamp(Load + Step(Random), 0.0f, 100.0f);
+			}
+
+			return Draw();
+		});
+	}
+
+	/// <summary>
+	///		Write results as JSON
+	/// </summary>
+	/// 
+	/// <param name="Path">Results file</param>
+	/// 
+	/// <returns>bool</returns>
+	bool WriteResults(const char* Path)
+	{
+		std::ofstream File(Path, std::ios::out | std::ios::trunc);
+
+		File << "{\n  \"wchar_size\": " << sizeof(wchar_t) << ",\n  \"results\": [\n";
+
+		for (size_t i = 0; i < Results.size(); i++)
+		{
+			auto& Measured { Results.at(i) };
+
+			File << "    {\"name\": \"" << Measured.Name << "\", \"inventory\": \"" << Measured.Inventory << "\", \"iterations\": " << Measured.Iterations
+				<< ", \"ns_per_op\": " << Measured.NanosecondsPerOp << ", \"allocs_per_op\": " << Measured.AllocationsPerOp
+				<< ", \"bytes_per_op\": " << Measured.BytesPerOp << ", \"ops_per_s\": " << 1e9 / Measured.NanosecondsPerOp
+				<< ", \"mb_per_s\": " << Measured.BytesPerOp / Measured.NanosecondsPerOp * 1e9 / 1048576 << "}" << (i + 1 < Results.size() ? ",\n" : "\n");
+		}
+
+		File << "  ]\n}\n";
+
+		return File.good();
+	}
+}
+
+/// <summary>
+///		Entry point
+/// </summary>
+/// 
+/// <param name="argc">Arguments count</param>
+/// <param name="argv">Arguments, the first one is results file</param>
+/// 
+/// <returns>int</returns>
+int main(int argc, char* argv[])
+{
+	const char* ResultsFile { argc > 1 ? argv[1] : BENCH_RESULTS_FILE };
+
+	for (auto& Size : { Bench::Shape { "small", 1, 1, 2 }, Bench::Shape { "medium", 8, 2, 8 }, Bench::Shape { "large", 64, 8, 64 } })
+	{
+		Bench::RunInventory(Size);
+	}
+
+	Bench::RunOutput(Bench::Shape { "large", 64, 8, 64 });
+	Bench::RunScreen();
+
+	if (!Bench::WriteResults(ResultsFile))
+	{
+		fprintf(stderr, "Can't write %s\n", ResultsFile);
+		return 1;
+	}
+
+	printf("Results were saved in %s\n", ResultsFile);
+
+	return 0;
+}
@@ -1,16 +1,68 @@
 #define _CRT_SECURE_NO_WARNINGS
 
 #include <locale.h>
+#include <cstdlib>
+#include <new>
 #include "../Api/cmd.h"
 
+/// <summary>
+///		Allocation counting for self overhead reports, every operator new form ends here
+/// </summary>
+/// 
+/// <param name="Size">Size</param>
+/// 
+/// <returns>void*</returns>
+void* operator new(size_t Size)
+{
+	SelfOverhead::CountAllocation();
+
+	if (void* Memory = malloc(Size ? Size : 1))
+	{
+		return Memory;
+	}
+
+	throw std::bad_alloc();
+}
+
+/// <summary>
+///		Free memory of counted allocation
+/// </summary>
+/// 
+/// <param name="Memory">Memory</param>
+void operator delete(void* Memory) noexcept
+{
+	free(Memory);
+}
+
+/// <summary>
+///		Free memory of counted allocation
+/// </summary>
+/// 
+/// <param name="Memory">Memory</param>
+/// <param name="Size">Size</param>
+void operator delete(void* Memory, size_t Size) noexcept
+{
+	free(Memory);
+}
+
 /// <summary>
 ///		Entry point
 /// </summary>
 /// 
+/// <param name="argc">Arguments count</param>
+/// <param name="argv">Arguments</param>
+/// 
 /// <returns>int</returns>
-int main()
+int wmain(int argc, wchar_t* argv[])
 {
 	setlocale(LC_ALL, "Russian");
+
+	// One-shot command, e.g. "ComStat disk get model size", script file or piped commands
+	if (argc > 1 || !CommandLine::IsInteractive())
+	{
+		return CommandLine::Execute(argc, argv);
+	}
+
 	CommandLine::Create();
 
 	return 0;